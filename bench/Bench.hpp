@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/**
+ * @file Bench.hpp
+ * @brief Helper comuni ai microbenchmark di tesi-bench.
+ *
+ * Ogni suite misura un blocco della pipeline isolato dagli altri, così una regressione in un
+ * percorso critico (code, pool di buffer, Emitter, passaggio dei task in ff_node_acc_t,
+ * kernel CPU) si vede senza passare dal tempo end-to-end di tesi-exec.
+ */
+
+// Parametri comuni a tutte le suite, dalla riga di comando di tesi-bench.
+struct BenchOptions {
+   size_t items = 1000000; // Operazioni (elementi, task) per misura
+   size_t capacity = 1024; // Capacità delle code limitate
+};
+
+// Suite disponibili, ognuna in un proprio file. Ritornano false se un controllo di
+// correttezza fallisce (kernel SIMD diversi da quelli scalari).
+bool run_queue_bench(const BenchOptions &options);
+bool run_buffer_bench(const BenchOptions &options);
+bool run_pipeline_bench(const BenchOptions &options);
+bool run_kernel_bench(const BenchOptions &options);
+
+using BenchClock = std::chrono::steady_clock;
+
+// Secondi trascorsi da 'start'.
+inline double seconds_since(BenchClock::time_point start) {
+   return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+/**
+ * @brief Stampa l'intestazione di una tabella con una colonna per il nome e due per i valori.
+ */
+inline void print_table_header(const std::string &title, const std::string &name,
+                               const std::string &first, const std::string &second) {
+   std::cout << "\n" << title << "\n"
+             << "------------------------------------------------------------------\n"
+             << std::left << std::setw(22) << name << std::right << std::setw(20) << first
+             << std::setw(24) << second << "\n"
+             << "------------------------------------------------------------------\n";
+}
+
+inline void print_table_row(const std::string &name, double first, double second) {
+   std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+             << std::setprecision(2) << std::setw(20) << first << std::setw(24) << second
+             << "\n";
+}
+
+inline void print_table_footer() {
+   std::cout << "------------------------------------------------------------------\n";
+}
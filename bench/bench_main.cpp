@@ -0,0 +1,86 @@
+/**
+ * @file bench_main.cpp
+ * @brief Punto d'ingresso di tesi-bench: esegue le suite di microbenchmark richieste.
+ *
+ * Uso: tesi-bench [ITEMS] [CAPACITY] [--suite=queue,buffer,pipeline,kernel]
+ * Senza --suite vengono eseguite tutte le suite. Termina con EXIT_FAILURE se un controllo di
+ * correttezza di una suite fallisce.
+ */
+
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Suite {
+   std::string name;
+   std::function<bool(const BenchOptions &)> run;
+};
+
+const std::vector<Suite> SUITES = {
+   {"queue", run_queue_bench},
+   {"buffer", run_buffer_bench},
+   {"pipeline", run_pipeline_bench},
+   {"kernel", run_kernel_bench},
+};
+
+void print_usage(const char *prog_name) {
+   std::cerr << "Usage: " << prog_name
+             << " [ITEMS] [CAPACITY] [--suite=queue,buffer,pipeline,kernel]\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+   BenchOptions options;
+   std::vector<std::string> selected;
+   std::vector<std::string> positional;
+
+   for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      if (arg.rfind("--suite=", 0) == 0) {
+         std::stringstream list(arg.substr(8));
+         std::string name;
+         while (std::getline(list, name, ','))
+            selected.push_back(name);
+      } else
+         positional.push_back(arg);
+   }
+   if (positional.size() > 0)
+      options.items = std::strtoull(positional[0].c_str(), nullptr, 10);
+   if (positional.size() > 1)
+      options.capacity = std::strtoull(positional[1].c_str(), nullptr, 10);
+   if (options.items == 0 || options.capacity == 0 || positional.size() > 2) {
+      print_usage(argv[0]);
+      return EXIT_FAILURE;
+   }
+
+   for (const auto &name : selected) {
+      bool known = false;
+      for (const auto &suite : SUITES)
+         known |= (suite.name == name);
+      if (!known) {
+         std::cerr << "Unknown suite '" << name << "'.\n";
+         print_usage(argv[0]);
+         return EXIT_FAILURE;
+      }
+   }
+
+   std::cout << "\nMicrobenchmarks (items=" << options.items
+             << ", capacity=" << options.capacity
+             << ", hw threads=" << std::thread::hardware_concurrency() << ")\n";
+
+   bool ok = true;
+   for (const auto &suite : SUITES)
+      if (selected.empty() ||
+          std::find(selected.begin(), selected.end(), suite.name) != selected.end())
+         ok = suite.run(options) && ok;
+
+   return ok ? 0 : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file buffer_bench.cpp
+ * @brief Microbenchmark del pool di buffer (BufferManager) di Gpu_OpenCL_Accelerator e
+ * Fpga_Accelerator.
+ *
+ * Misura il costo di una coppia acquire_buffer_set/release_buffer_set con i set già allocati:
+ * - da un solo thread, con una dimensione o alternando due classi di dimensione;
+ * - da due thread, come Producer e Consumer di ff_node_acc_t, che si contendono il mutex del
+ *   pool.
+ * Usa il primo dispositivo OpenCL disponibile, di qualsiasi tipo; senza dispositivi la suite
+ * viene saltata.
+ */
+
+#include "../src/common/QueueFactory.hpp"
+#include "../src/strategy_accelerator/accelerator/BufferManager.hpp"
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Dimensione in elementi dei task simulati (i buffer non vengono mai letti né scritti).
+constexpr size_t TASK_N = 1 << 16;
+
+/**
+ * Cerca il primo dispositivo OpenCL e crea contesto e coda. false se non ce ne sono.
+ */
+bool open_first_device(cl_device_id &device, cl_context &context, cl_command_queue &queue) {
+   cl_uint num_platforms = 0;
+   if (clGetPlatformIDs(0, NULL, &num_platforms) != CL_SUCCESS || num_platforms == 0)
+      return false;
+   std::vector<cl_platform_id> platforms(num_platforms);
+   clGetPlatformIDs(num_platforms, platforms.data(), NULL);
+
+   for (cl_platform_id platform : platforms) {
+      if (clGetDeviceIDs(platform, CL_DEVICE_TYPE_ALL, 1, &device, NULL) != CL_SUCCESS)
+         continue;
+      cl_int ret;
+      context = clCreateContext(NULL, 1, &device, NULL, NULL, &ret);
+      if (ret != CL_SUCCESS)
+         continue;
+      queue = clCreateCommandQueue(context, device, 0, &ret);
+      if (ret == CL_SUCCESS)
+         return true;
+      clReleaseContext(context);
+   }
+   return false;
+}
+
+/**
+ * Costo medio (ns) di acquire + release da un thread. Con 'two_sizes' le richieste alternano
+ * task di TASK_N e TASK_N / 2 elementi, che appartengono a due classi diverse.
+ */
+double measure_single(BufferManager &pool, size_t pairs, bool two_sizes) {
+   auto t0 = BenchClock::now();
+   for (size_t i = 0; i < pairs; ++i) {
+      size_t n = (two_sizes && (i & 1)) ? TASK_N / 2 : TASK_N;
+      pool.release_buffer_set(pool.acquire_buffer_set(sizeof(int) * n));
+   }
+   return seconds_since(t0) * 1.0e9 / pairs;
+}
+
+/**
+ * Costo medio (ns per coppia) con un thread che acquisisce e passa i set a un secondo thread
+ * che li rilascia: l'acquisizione attende quando tutti i set del pool sono in uso.
+ */
+double measure_handoff(BufferManager &pool, size_t pairs) {
+   auto queue = make_queue<void *>(QueueKind::Blocking, WaitKind::SpinPark, 0);
+
+   auto t0 = BenchClock::now();
+   std::thread releaser([&] {
+      for (size_t i = 0; i < pairs; ++i)
+         pool.release_buffer_set(reinterpret_cast<size_t>(queue->pop()));
+   });
+   for (size_t i = 0; i < pairs; ++i)
+      queue->push(reinterpret_cast<void *>(pool.acquire_buffer_set(sizeof(int) * TASK_N)));
+   releaser.join();
+
+   return seconds_since(t0) * 1.0e9 / pairs;
+}
+
+} // namespace
+
+bool run_buffer_bench(const BenchOptions &options) {
+   cl_device_id device;
+   cl_context context;
+   cl_command_queue queue;
+   if (!open_first_device(device, context, queue)) {
+      std::cout << "\nBuffer pool: no OpenCL device found, skipped.\n";
+      return true;
+   }
+
+   char device_name[256] = {0};
+   clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(device_name) - 1, device_name, NULL);
+   size_t pairs = std::max<size_t>(options.items / 10, 1);
+
+   print_table_header(std::string("Buffer pool (") + device_name +
+                         ", pairs=" + std::to_string(pairs) + ")",
+                      "Pool", "1 size (ns/pair)", "2 sizes (ns/pair)");
+
+   // Pool fisso (niente adattamento durante la misura) e adattivo, con le classi dei task
+   // già allocate alla costruzione.
+   for (size_t pool_size : {size_t(4), size_t(0)}) {
+      RunConfig config;
+      config.pool_size = pool_size;
+      config.expected_n = TASK_N;
+      config.mixed_n = 2;
+      auto pool = std::make_unique<BufferManager>(context, device, queue, config);
+      print_table_row(pool_size ? "fixed (4 sets)" : "auto",
+                      measure_single(*pool, pairs, false), measure_single(*pool, pairs, true));
+   }
+   print_table_footer();
+
+   {
+      RunConfig config;
+      config.pool_size = 4;
+      config.expected_n = TASK_N;
+      BufferManager pool(context, device, queue, config);
+      std::cout << "Acquire/release across two threads: " << std::fixed
+                << std::setprecision(2) << measure_handoff(pool, pairs) << " ns/pair\n";
+      print_table_footer();
+   }
+
+   clReleaseCommandQueue(queue);
+   clReleaseContext(context);
+   return true;
+}
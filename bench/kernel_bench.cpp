@@ -0,0 +1,168 @@
+/**
+ * @file kernel_bench.cpp
+ * @brief Microbenchmark dei kernel CPU: il loop eseguito su ogni intervallo di elementi da
+ * AbstractCpuRunner::execute_kernel_range, su un solo thread.
+ *
+ * Il runner di prova calcola tutti gli elementi come un unico intervallo, quindi il tempo per
+ * elemento misura solo il kernel, senza il costo e la variabilità del parallel_for. Ogni
+ * kernel viene misurato in versione scalare e con ogni set di istruzioni SIMD supportato
+ * dalla CPU, controllando che i risultati SIMD siano identici a quelli scalari: sui dati del
+ * benchmark (tutti gli N elementi), su input con segno su tutto il range di int e su
+ * intervalli corti con inizio e fine non allineati alle corsie. Un risultato diverso fa
+ * fallire la suite (tesi-bench termina con un codice diverso da 0).
+ */
+
+#include "../src/strategy_cpu/AbstractCpuRunner.hpp"
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/**
+ * Runner CPU con il loop "parallelo" eseguito da un solo thread.
+ */
+class SequentialKernelRunner : public AbstractCpuRunner {
+ public:
+   SequentialKernelRunner(const std::string &kernel_name, size_t n, SimdMode simd)
+       : AbstractCpuRunner(kernel_name, "CPU Sequential", simd) {
+      a_.resize(n);
+      b_.resize(n);
+      c_.resize(n);
+      for (size_t i = 0; i < n; ++i) {
+         a_[i] = int(i);
+         b_[i] = int(2 * i);
+      }
+   }
+
+   // Calcola una volta tutti gli elementi, ritorna un valore del risultato (per evitare che
+   // il compilatore elimini il calcolo).
+   int run_once() {
+      execute_parallel_loop(0, static_cast<long>(c_.size()));
+      return c_[c_.size() / 2];
+   }
+
+   const std::vector<int> &output() const { return c_; }
+
+ protected:
+   void execute_parallel_loop(long start, long end) override {
+      execute_kernel_range(start, end);
+   }
+};
+
+/**
+ * Tempo per elemento (ns) del kernel, ripetendo il calcolo per almeno ~0.2 s, così anche
+ * vecAdd ha una misura stabile.
+ */
+double measure_kernel(SequentialKernelRunner &runner, size_t n) {
+   volatile int sink = runner.run_once(); // Riscaldamento (pagine e cache)
+
+   size_t rounds = 0;
+   auto t0 = BenchClock::now();
+   double seconds = 0;
+   do {
+      sink = runner.run_once();
+      ++rounds;
+      seconds = seconds_since(t0);
+   } while (seconds < 0.2);
+
+   (void)sink;
+   return seconds * 1.0e9 / (double(rounds) * n);
+}
+
+/**
+ * Elementi diversi fra il kernel SIMD e quello scalare su input con segno (pseudo-casuali su
+ * tutto il range di int, con INT_MIN, INT_MAX, 0 e -1 ai bordi), calcolati su [0, n) e su
+ * ogni intervallo [start, end) corto con start e lunghezza qualsiasi: coprono le code più
+ * corte delle corsie e gli inizi non allineati.
+ */
+size_t count_signed_mismatches(KernelRangeFn simd, KernelRangeFn scalar, size_t n) {
+   constexpr size_t MAX_SHORT = 70; // Più di due registri AVX-512 di int, più una coda
+   n = std::max(n, MAX_SHORT + 8);
+
+   std::vector<int> a(n), b(n), c_simd(n), c_scalar(n);
+   uint32_t state = 0x9e3779b9u;
+   for (size_t i = 0; i < n; ++i) {
+      state = state * 1664525u + 1013904223u; // LCG: bit alti distribuiti su tutto il range
+      a[i] = int32_t(state);
+      state = state * 1664525u + 1013904223u;
+      b[i] = int32_t(state);
+   }
+   const int edges[] = {INT32_MIN, INT32_MAX, 0, -1};
+   for (size_t k = 0; k < 4; ++k) {
+      a[k] = b[n - 1 - k] = edges[k];
+      b[k] = a[n - 1 - k] = edges[3 - k];
+   }
+
+   size_t differing = 0;
+   auto compare = [&](long start, long end) {
+      simd(a.data(), b.data(), c_simd.data(), start, end);
+      scalar(a.data(), b.data(), c_scalar.data(), start, end);
+      for (long i = start; i < end; ++i)
+         differing += (c_simd[i] != c_scalar[i]);
+   };
+   compare(0, long(n));
+   for (long start = 0; start < 8; ++start)
+      for (long len = 1; len <= long(MAX_SHORT); ++len)
+         compare(start, start + len);
+   return differing;
+}
+
+} // namespace
+
+bool run_kernel_bench(const BenchOptions &options) {
+   const size_t n = options.items;
+   const std::vector<std::pair<std::string, std::string>> kernels = {
+      {"vecAdd", "vecAdd"},
+      {"polynomial_op", "polynomial"},
+      {"heavy_compute_kernel", "heavy_compute"}};
+
+   // Kernel scalari e versioni SIMD supportate dalla CPU.
+   std::vector<SimdMode> levels = {SimdMode::Off};
+   for (SimdMode level : {SimdMode::Sse42, SimdMode::Avx2, SimdMode::Avx512})
+      if (level <= detect_simd())
+         levels.push_back(level);
+
+   print_table_header("CPU kernels, one thread (N=" + std::to_string(n) + ")", "Kernel",
+                      "ns/element", "M elements/s");
+   std::vector<std::string> mismatches;
+   for (const auto &[kernel, label] : kernels) {
+      std::vector<int> scalar_output;
+      for (SimdMode level : levels) {
+         SequentialKernelRunner runner(kernel, n, level);
+         double ns = measure_kernel(runner, n);
+         print_table_row(label + " " + simd_name(level), ns, 1.0e3 / ns);
+
+         // Confronto bit a bit con il kernel scalare.
+         if (level == SimdMode::Off) {
+            scalar_output = runner.output();
+            continue;
+         }
+         size_t differing = 0;
+         for (size_t i = 0; i < n; ++i)
+            differing += (runner.output()[i] != scalar_output[i]);
+         if (differing > 0)
+            mismatches.push_back(kernel + " " + simd_name(level) + ": " +
+                                 std::to_string(differing) + " elements");
+
+         differing = count_signed_mismatches(select_cpu_kernel(kernel, level),
+                                             select_cpu_kernel(kernel, SimdMode::Off), n);
+         if (differing > 0)
+            mismatches.push_back(kernel + " " + simd_name(level) + ": " +
+                                 std::to_string(differing) +
+                                 " elements with signed inputs or short ranges");
+      }
+   }
+   print_table_footer();
+
+   if (levels.size() > 1) {
+      std::cout << "SIMD vs scalar results: "
+                << (mismatches.empty() ? "bit-identical" : "MISMATCH") << "\n";
+      for (const auto &mismatch : mismatches)
+         std::cout << "   " << mismatch << "\n";
+   }
+   return mismatches.empty();
+}
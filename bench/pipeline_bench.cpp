@@ -0,0 +1,127 @@
+/**
+ * @file pipeline_bench.cpp
+ * @brief Microbenchmark dei nodi FastFlow della pipeline: generazione dei task nell'Emitter e
+ * passaggio dei task attraverso ff_node_acc_t.
+ *
+ * Il nodo ff_node_acc_t usa un acceleratore che non fa nulla (NoopAccelerator), quindi il
+ * tempo per task misura solo il costo della pipeline interna: code fra gli stadi, misure dei
+ * tempi, statistiche e pool di buffer banale.
+ */
+
+#include "../src/common/StatsCollector.hpp"
+#include "../src/ff_Pipe_nodes/Emitter.hpp"
+#include "../src/ff_Pipe_nodes/ff_node_acc_t.hpp"
+#include "Bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/**
+ * Acceleratore senza device: ogni stadio ritorna subito, i buffer set sono sempre liberi.
+ */
+class NoopAccelerator : public IAccelerator {
+ public:
+   bool initialize() override { return true; }
+   void send_data_to_device(void *) override {}
+   void execute_kernel(void *) override {}
+   void get_results_from_device(void *, long long &computed_ns) override { computed_ns = 0; }
+   size_t acquire_buffer_set(size_t) override { return 0; }
+   void release_buffer_set(size_t) override {}
+};
+
+/**
+ * Task generati al secondo dall'Emitter (in milioni), chiamando direttamente svc(). Ogni task
+ * viene rilasciato subito, quindi con il pool di task resta sempre uno slot libero.
+ */
+double measure_emitter(size_t tasks, size_t size_levels, size_t pool_slots = 0) {
+   Emitter emitter(1024, tasks, size_levels, pool_slots);
+
+   auto t0 = BenchClock::now();
+   for (void *task = emitter.svc(nullptr); task != FF_EOS; task = emitter.svc(nullptr))
+      release_task(static_cast<Task *>(task));
+   return tasks / seconds_since(t0) / 1.0e6;
+}
+
+/**
+ * Tempo medio per task (ns) di una pipeline Emitter -> ff_node_acc_t con NoopAccelerator. Con
+ * chained > 1 i nodi sono in serie: tutti tranne l'ultimo inviano i task al successivo.
+ */
+double measure_node(size_t tasks, const RunConfig &config, size_t chained = 1) {
+   std::vector<NoopAccelerator> accelerators(chained);
+   std::vector<StatsCollector> stats(chained);
+   auto count_future = stats.back().count_promise.get_future();
+
+   Emitter emitter(1, tasks);
+   std::vector<std::unique_ptr<ff_node_acc_t>> nodes;
+   ff_Pipe<> pipe(&emitter);
+   for (size_t i = 0; i < chained; ++i) {
+      nodes.push_back(std::make_unique<ff_node_acc_t>(&accelerators[i], &stats[i], config));
+      nodes.back()->set_forward_output(i + 1 < chained);
+      pipe.add_stage(nodes.back().get());
+   }
+
+   auto t0 = BenchClock::now();
+   if (pipe.run_and_wait_end() < 0) {
+      std::cerr << "[ERROR] Pipeline benchmark failed.\n";
+      exit(EXIT_FAILURE);
+   }
+   double seconds = seconds_since(t0);
+
+   if (count_future.get() != tasks) {
+      std::cerr << "[ERROR] Pipeline benchmark lost tasks.\n";
+      exit(EXIT_FAILURE);
+   }
+   return seconds * 1.0e9 / tasks;
+}
+
+} // namespace
+
+bool run_pipeline_bench(const BenchOptions &options) {
+   size_t tasks = std::max<size_t>(options.items / 10, 1);
+
+   std::cout << "\nEmitter (tasks=" << tasks << ")\n"
+             << "------------------------------------------------------------------\n"
+             << "Task generation, one size:    " << std::fixed << std::setprecision(2)
+             << measure_emitter(tasks, 1) << " M tasks/s\n"
+             << "Task generation, mixed sizes: " << measure_emitter(tasks, 4)
+             << " M tasks/s\n"
+             << "Task generation, task pool:   " << measure_emitter(tasks, 1, 64)
+             << " M tasks/s\n";
+   print_table_footer();
+
+   struct NodeVariant {
+      std::string name;
+      QueueKind queue;
+      size_t stages;
+      CompletionMode completion;
+      size_t chained = 1; // Nodi ff_node_acc_t in serie
+   };
+   const std::vector<NodeVariant> variants = {
+      {"blocking, 2 stages", QueueKind::Blocking, 2, CompletionMode::Blocking},
+      {"blocking, 3 stages", QueueKind::Blocking, 3, CompletionMode::Blocking},
+      {"spsc, 2 stages", QueueKind::Spsc, 2, CompletionMode::Blocking},
+      {"spsc, 3 stages", QueueKind::Spsc, 3, CompletionMode::Blocking},
+      {"spsc, callback", QueueKind::Spsc, 2, CompletionMode::Callback},
+      {"spsc, 2 chained nodes", QueueKind::Spsc, 2, CompletionMode::Blocking, 2},
+   };
+
+   // Il nodo stampa i propri messaggi di avvio e di chiusura su stderr.
+   print_table_header("ff_node_acc_t handoff, no-op accelerator (tasks=" +
+                         std::to_string(tasks) + ")",
+                      "Internal pipeline", "ns/task", "M tasks/s");
+   for (const auto &v : variants) {
+      RunConfig config;
+      config.queue_kind = v.queue;
+      config.queue_capacity = options.capacity;
+      config.acc_stages = v.stages;
+      config.completion = v.completion;
+      double ns = measure_node(tasks, config, v.chained);
+      print_table_row(v.name, ns, 1.0e3 / ns);
+   }
+   print_table_footer();
+   return true;
+}
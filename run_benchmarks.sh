@@ -9,6 +9,18 @@ OUTPUT_FILE="$OUTPUT_DIR/Measurements.csv"
 N_VALUES=(10000 1000000 7449999)
 NUM_TASKS=100
 
+# Sweep della dimensione dei chunk (--chunk-size, 0 = task intero) sull'N più grande.
+CHUNK_OUTPUT_FILE="$OUTPUT_DIR/Chunk_Sweep.csv"
+CHUNK_N=7449999
+CHUNK_SIZES=(0 4194304 2097152 1048576 524288 262144)
+
+# Confronto delle modalità di memoria (--mem) su tutti gli N.
+MEM_OUTPUT_FILE="$OUTPUT_DIR/Mem_Sweep.csv"
+MEM_MODES=(copy pinned zero_copy)
+
+# Esecuzioni fallite, che non hanno scritto la propria riga di risultati.
+FAILED_OUTPUT_FILE="$OUTPUT_DIR/Failed_Runs.csv"
+
 # Controlla se il file eseguibile esiste. Se non esiste, avvia la build automatica.
 EXECUTABLE="./build/tesi-exec"
 if [ ! -f "$EXECUTABLE" ]; then
@@ -37,10 +49,12 @@ else
     echo
 fi
 
-# Pulisce il file CSV precedente e scrive l'intestazione.
-echo "OS,N,Tasks,Device,Kernel,Avg_Service_Time_ms,Avg_In_Node_Time_ms,Avg_Compute_Time_ms,Avg_Overhead_Time_ms,Throughput_tasks_s,Total_Time_s,Status" > $OUTPUT_FILE
+# Pulisce i file CSV precedenti. Ogni esecuzione aggiunge la propria riga con --output=csv
+# (tutti i risultati, la configurazione e l'ambiente), con l'intestazione se il file è vuoto.
+rm -f $OUTPUT_FILE $CHUNK_OUTPUT_FILE $MEM_OUTPUT_FILE
+echo "OS,N,Tasks,Device,Kernel,Options,Status" > $FAILED_OUTPUT_FILE
 
-# Funzione helper per eseguire un singolo test e fare il parsing dell'output.
+# Funzione helper per eseguire un singolo test.
 run_test() {
     local N=$1
     local DEVICE=$2
@@ -51,26 +65,52 @@ run_test() {
     echo "Running: OS=$OS_NAME, N=$N, Device=$DEVICE, Kernel=$KERNEL_NAME"
 
     # Esegue il comando e cattura sia stdout che stderr.
-    output=$( $EXECUTABLE $N $NUM_TASKS $DEVICE $KERNEL_ARG 2>&1 )
+    output=$( $EXECUTABLE $N $NUM_TASKS $DEVICE $KERNEL_ARG --output=csv --output-file=$OUTPUT_FILE 2>&1 )
     
     # Controlla se l'esecuzione è fallita.
     if [ $? -ne 0 ]; then
         echo "Run FAILED for $DEVICE, $KERNEL_NAME, N=$N"
-        echo "$OS_NAME,$N,$NUM_TASKS,$DEVICE,$KERNEL_NAME,,,,,,,FAILED" >> $OUTPUT_FILE
+        echo "$OS_NAME,$N,$NUM_TASKS,$DEVICE,$KERNEL_NAME,,FAILED" >> $FAILED_OUTPUT_FILE
         echo "$output"
-        return
     fi
+}
+
+# Funzione helper per lo sweep della dimensione dei chunk su un acceleratore.
+run_chunk_sweep() {
+    local DEVICE=$1
+    local KERNEL_ARG=$2
+    local KERNEL_NAME=$3
+    local OS_NAME=$4
+
+    for CHUNK in "${CHUNK_SIZES[@]}"; do
+        echo "Running chunk sweep: OS=$OS_NAME, N=$CHUNK_N, Device=$DEVICE, Kernel=$KERNEL_NAME, Chunk=$CHUNK"
+
+        output=$( $EXECUTABLE $CHUNK_N $NUM_TASKS $DEVICE $KERNEL_ARG --chunk-size=$CHUNK --output=csv --output-file=$CHUNK_OUTPUT_FILE 2>&1 )
+        if [ $? -ne 0 ]; then
+            echo "Run FAILED for $DEVICE, $KERNEL_NAME, chunk=$CHUNK"
+            echo "$OS_NAME,$CHUNK_N,$NUM_TASKS,$DEVICE,$KERNEL_NAME,--chunk-size=$CHUNK,FAILED" >> $FAILED_OUTPUT_FILE
+        fi
+    done
+}
 
-    # --- Parsing delle metriche dall'output ---
-    SERVICE_TIME=$(echo "$output" | grep "Avg Service Time" | awk -F: '{print $2}' | awk '{print $1}')
-    IN_NODE_TIME=$(echo "$output" | grep "Avg In_Node Time" | awk -F: '{print $2}' | awk '{print $1}')
-    COMPUTE_TIME=$(echo "$output" | grep "Avg Pure Compute Time" | awk -F: '{print $2}' | awk '{print $1}')
-    OVERHEAD_TIME=$(echo "$output" | grep "Avg Overhead Time" | awk -F: '{print $2}' | awk '{print $1}')
-    THROUGHPUT=$(echo "$output" | grep "Throughput" | awk -F: '{print $2}' | awk '{print $1}')
-    TOTAL_TIME=$(echo "$output" | grep "Total Time Elapsed" | awk -F: '{print $2}' | awk '{print $1}')
+# Funzione helper per il confronto delle modalità di memoria su un acceleratore.
+run_mem_sweep() {
+    local DEVICE=$1
+    local KERNEL_ARG=$2
+    local KERNEL_NAME=$3
+    local OS_NAME=$4
 
-    # Scrive la riga CSV.
-    echo "$OS_NAME,$N,$NUM_TASKS,$DEVICE,$KERNEL_NAME,$SERVICE_TIME,$IN_NODE_TIME,$COMPUTE_TIME,$OVERHEAD_TIME,$THROUGHPUT,$TOTAL_TIME,Success" >> $OUTPUT_FILE
+    for N in "${N_VALUES[@]}"; do
+        for MEM in "${MEM_MODES[@]}"; do
+            echo "Running mem sweep: OS=$OS_NAME, N=$N, Device=$DEVICE, Kernel=$KERNEL_NAME, Mem=$MEM"
+
+            output=$( $EXECUTABLE $N $NUM_TASKS $DEVICE $KERNEL_ARG --mem=$MEM --output=csv --output-file=$MEM_OUTPUT_FILE 2>&1 )
+            if [ $? -ne 0 ]; then
+                echo "Run FAILED for $DEVICE, $KERNEL_NAME, N=$N, mem=$MEM"
+                echo "$OS_NAME,$N,$NUM_TASKS,$DEVICE,$KERNEL_NAME,--mem=$MEM,FAILED" >> $FAILED_OUTPUT_FILE
+            fi
+        done
+    done
 }
 
 # Rileva il sistema operativo.
@@ -101,6 +141,12 @@ if [ "$OS_NAME" == "Darwin" ]; then
         done
     done
 
+    run_chunk_sweep "gpu_opencl" "kernels/gpu/polynomial_op.cl" "polynomial_op" $OS_NAME
+    run_chunk_sweep "gpu_opencl" "kernels/gpu/heavy_compute_kernel.cl" "heavy_compute_kernel" $OS_NAME
+
+    run_mem_sweep "gpu_opencl" "kernels/gpu/vecAdd.cl" "vecAdd" $OS_NAME
+    run_mem_sweep "gpu_opencl" "kernels/gpu/polynomial_op.cl" "polynomial_op" $OS_NAME
+
 elif [ "$OS_NAME" == "Linux" ]; then
     # --- Comandi Linux VM ---
     OS_NAME="Linux"
@@ -126,6 +172,12 @@ elif [ "$OS_NAME" == "Linux" ]; then
         done
     done
 
+    run_chunk_sweep "fpga" "kernels/fpga/krnl_polynomial_op.xclbin" "polynomial_op" $OS_NAME
+    run_chunk_sweep "fpga" "kernels/fpga/krnl_heavy_compute.xclbin" "heavy_compute_kernel" $OS_NAME
+
+    run_mem_sweep "fpga" "kernels/fpga/krnl_vadd.xclbin" "vecAdd" $OS_NAME
+    run_mem_sweep "fpga" "kernels/fpga/krnl_polynomial_op.xclbin" "polynomial_op" $OS_NAME
+
 else
     echo "Sistema operativo non supportato: $OS_NAME"
     exit 1
@@ -134,4 +186,7 @@ fi
 echo "----------------------------------------"
 echo "Benchmark completati."
 echo "Risultati salvati in: $OUTPUT_FILE"
+echo "Sweep dei chunk salvato in: $CHUNK_OUTPUT_FILE"
+echo "Confronto delle modalità di memoria salvato in: $MEM_OUTPUT_FILE"
+echo "Esecuzioni fallite elencate in: $FAILED_OUTPUT_FILE"
 echo "----------------------------------------"
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * @brief Allocatore per std::vector che allinea i dati a ALIGN byte (di default una pagina).
+ *
+ * I runtime OpenCL usano la memoria dell'host senza copie (CL_MEM_USE_HOST_PTR, vedi
+ * RunConfig::mem_mode) solo se è allineata alla pagina; con memoria non allineata ricadono su
+ * una copia interna.
+ */
+template <typename T, size_t ALIGN = 4096> struct AlignedAllocator {
+   using value_type = T;
+
+   template <typename U> struct rebind {
+      using other = AlignedAllocator<U, ALIGN>;
+   };
+
+   AlignedAllocator() noexcept = default;
+   template <typename U> AlignedAllocator(const AlignedAllocator<U, ALIGN> &) noexcept {}
+
+   T *allocate(size_t n) {
+      return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(ALIGN)));
+   }
+
+   void deallocate(T *ptr, size_t) noexcept {
+      ::operator delete(ptr, std::align_val_t(ALIGN));
+   }
+
+   template <typename U> bool operator==(const AlignedAllocator<U, ALIGN> &) const noexcept {
+      return true;
+   }
+   template <typename U> bool operator!=(const AlignedAllocator<U, ALIGN> &) const noexcept {
+      return false;
+   }
+};
+
+// Vettore di dati dell'host allineato alla pagina.
+template <typename T> using HostVector = std::vector<T, AlignedAllocator<T>>;
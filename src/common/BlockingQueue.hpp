@@ -1,5 +1,7 @@
 #pragma once
 
+#include "IQueue.hpp"
+
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -9,25 +11,38 @@
  *
  * Mette i thread consumer a dormire quando la coda è vuota e li risveglia
  * quando un nuovo elemento è disponibile, evitando l'attesa attiva.
+ * Con capacity > 0 la coda è limitata e anche i producer attendono quando è piena.
  */
-template <typename T> class BlockingQueue {
+template <typename T> class BlockingQueue : public IQueue<T> {
  public:
-   void push(T value) {
+   explicit BlockingQueue(size_t capacity = 0) : capacity_(capacity) {}
+
+   void push(T value) override {
       {
-         std::lock_guard<std::mutex> lock(mutex_);
+         std::unique_lock<std::mutex> lock(mutex_);
+
+         if (capacity_ > 0)
+            notFullCondition_.wait(lock, [this] { return queue_.size() < capacity_; });
+
          queue_.push(std::move(value));
       }
 
       notEmptyCondition_.notify_one();
    }
 
-   T pop() {
-      std::unique_lock<std::mutex> lock(mutex_);
+   T pop() override {
+      T item;
+      {
+         std::unique_lock<std::mutex> lock(mutex_);
+
+         notEmptyCondition_.wait(lock, [this] { return !queue_.empty(); });
 
-      notEmptyCondition_.wait(lock, [this] { return !queue_.empty(); });
+         item = std::move(queue_.front());
+         queue_.pop();
+      }
 
-      T item = std::move(queue_.front());
-      queue_.pop();
+      if (capacity_ > 0)
+         notFullCondition_.notify_one();
       return item;
    }
 
@@ -35,4 +50,6 @@ template <typename T> class BlockingQueue {
    std::queue<T> queue_;
    std::mutex mutex_;
    std::condition_variable notEmptyCondition_;
-};
\ No newline at end of file
+   std::condition_variable notFullCondition_;
+   size_t capacity_; // 0 = coda illimitata
+};
@@ -1,6 +1,41 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <string>
+
+/**
+ * @brief Stadi della pipeline interna di ff_node_acc_t, usati come indici delle metriche
+ * raccolte per stadio.
+ */
+enum PipelineStage : size_t { STAGE_UPLOAD = 0, STAGE_LAUNCH, STAGE_DOWNLOAD, NUM_STAGES };
+
+/**
+ * @brief Tempi misurati sul device con il profiling OpenCL (RunConfig::profile), usati come
+ * indici delle metriche per lancio. H2D, kernel e D2H vanno dall'inizio del primo comando
+ * dello stadio alla fine dell'ultimo; QUEUED e SUBMITTED sommano sui tre stadi l'attesa del
+ * primo comando nella coda del runtime (QUEUED -> SUBMIT) e sul device (SUBMIT -> START).
+ */
+enum DeviceTime : size_t {
+   DEVICE_H2D = 0,
+   DEVICE_KERNEL,
+   DEVICE_D2H,
+   DEVICE_QUEUED,
+   DEVICE_SUBMITTED,
+   NUM_DEVICE_TIMES
+};
+
+/**
+ * @brief Percentili di una distribuzione di latenze (in ns), calcolati da LatencyHistogram.
+ */
+struct LatencyPercentiles {
+   size_t count = 0; // Latenze registrate
+   long long p50_ns = 0;
+   long long p90_ns = 0;
+   long long p99_ns = 0;
+   long long p999_ns = 0;
+   long long max_ns = 0;
+};
 
 /**
  * @brief Struct dati generica per i risultati di qualsiasi strategia.
@@ -16,4 +51,36 @@ struct ComputeResult {
    long long computed_ns = 0;              // Tempo effettivo di calcolo del kernel
    long long total_InNode_time_ns = 0;     // Tempo totale trascorso dai task dentro il nodo accelerato
    long long inter_completion_time_ns = 0; // Tempo medio tra il completamento di due task consecutivi.
+
+   // Metriche per stadio della pipeline interna (solo acceleratori).
+   std::array<long long, NUM_STAGES> stage_busy_ns{}; // Tempo speso nel lavoro dello stadio
+   std::array<long long, NUM_STAGES> stage_wait_ns{}; // Tempo speso in attesa di un task
+   long long buffer_wait_ns = 0;                      // Attesa di un buffer set libero
+   size_t buffer_sets_peak = 0;  // Buffer set in uso contemporaneamente, al massimo
+   size_t buffer_sets_final = 0; // Buffer set nel pool a fine esecuzione
+
+   // Tempi sul device sommati sui lanci profilati (solo con il profiling OpenCL).
+   std::array<long long, NUM_DEVICE_TIMES> device_ns{};
+   size_t profiled_launches = 0;
+
+   // Distribuzioni per task di tempo nel nodo, tempo di calcolo e tempo fra due completamenti.
+   LatencyPercentiles in_node_latency;
+   LatencyPercentiles computed_latency;
+   LatencyPercentiles inter_completion_latency;
+
+   // Nomi dei dispositivi usati dagli acceleratori, separati da ", " (vuoto su CPU).
+   std::string device_names;
+
+   // Avvio degli acceleratori, prima della misura di elapsed_ns: inizializzazione e warm-up
+   // più lenti fra i nodi e compilazione dei programmi OpenCL (sommata sugli acceleratori, con
+   // o senza la cache dei binari).
+   long long startup_ns = 0;
+   long long warmup_ns = 0;
+   size_t warmup_tasks = 0; // Task di warm-up per acceleratore, esclusi dalle statistiche
+   long long program_build_ns = 0;
+   size_t programs_cached = 0;
+   size_t programs_compiled = 0;
+
+   // Tempo dall'avvio della pipeline al completamento del primo task.
+   long long first_task_ns = 0;
 };
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * @brief Interfaccia comune alle code usate per la comunicazione tra gli stadi della pipeline
+ * interna di ff_node_acc_t.
+ *
+ * Permette di scegliere a runtime l'implementazione (BlockingQueue, SpscQueue, MpmcQueue)
+ * senza modificare il codice dei thread che la usano.
+ */
+template <typename T> class IQueue {
+ public:
+   virtual ~IQueue() = default;
+
+   // Inserisce un elemento, attendendo se la coda è piena (solo per le code limitate).
+   virtual void push(T value) = 0;
+
+   // Estrae un elemento, attendendo se la coda è vuota.
+   virtual T pop() = 0;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "ComputeResult.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Istogramma delle latenze (in ns) a bucket logaritmici, nello stile di HdrHistogram.
+ *
+ * Ogni potenza di due [2^m, 2^(m+1)) è divisa in SUB_COUNT bucket lineari, quindi l'errore
+ * relativo di un percentile è al più 1/SUB_COUNT (< 1%) su tutto l'intervallo, con memoria
+ * fissa. I valori sotto SUB_COUNT ns sono esatti, quelli oltre 2^(MAX_MAGNITUDE+1) ns (circa
+ * 36 minuti) finiscono nell'ultimo bucket.
+ *
+ * La registrazione è lock-free (un fetch_add rilassato sul bucket, più il massimo), così i
+ * thread Consumer di più nodi e i worker CPU possono aggiornare lo stesso istogramma. La
+ * lettura dei percentili va fatta a registrazioni terminate.
+ */
+class LatencyHistogram {
+ public:
+   static constexpr size_t SUB_BITS = 7;
+   static constexpr size_t SUB_COUNT = size_t(1) << SUB_BITS;
+   static constexpr size_t MAX_MAGNITUDE = 40;
+   static constexpr size_t NUM_BUCKETS =
+      SUB_COUNT + (MAX_MAGNITUDE - SUB_BITS + 1) * SUB_COUNT;
+
+   /**
+    * @brief Registra una latenza. I valori negativi vengono contati come 0.
+    */
+   void record(long long value_ns) {
+      uint64_t value = value_ns > 0 ? static_cast<uint64_t>(value_ns) : 0;
+      buckets_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+      count_.fetch_add(1, std::memory_order_relaxed);
+
+      uint64_t current = max_.load(std::memory_order_relaxed);
+      while (value > current &&
+             !max_.compare_exchange_weak(current, value, std::memory_order_relaxed))
+         ;
+   }
+
+   size_t count() const { return count_.load(std::memory_order_relaxed); }
+   long long max() const {
+      return static_cast<long long>(max_.load(std::memory_order_relaxed));
+   }
+
+   /**
+    * @brief Percentile p (0-100): il valore più alto del bucket che contiene la p-esima
+    * latenza in ordine crescente, limitato al massimo registrato. 0 se l'istogramma è vuoto.
+    */
+   long long percentile(double p) const {
+      size_t total = count();
+      if (total == 0)
+         return 0;
+
+      // Rango (1-based) della latenza cercata.
+      size_t rank = static_cast<size_t>(p / 100.0 * total + 0.5);
+      rank = rank < 1 ? 1 : (rank > total ? total : rank);
+
+      size_t seen = 0;
+      for (size_t i = 0; i < NUM_BUCKETS; ++i) {
+         seen += buckets_[i].load(std::memory_order_relaxed);
+         if (seen >= rank && i + 1 < NUM_BUCKETS) {
+            long long upper = static_cast<long long>(bucket_upper(i));
+            return upper < max() ? upper : max();
+         }
+      }
+      return max();
+   }
+
+   /**
+    * @brief Percentili riportati nei risultati (p50, p90, p99, p99.9 e massimo).
+    */
+   LatencyPercentiles summary() const {
+      LatencyPercentiles res;
+      res.count = count();
+      res.p50_ns = percentile(50.0);
+      res.p90_ns = percentile(90.0);
+      res.p99_ns = percentile(99.0);
+      res.p999_ns = percentile(99.9);
+      res.max_ns = max();
+      return res;
+   }
+
+ private:
+   // Indice del bucket di un valore.
+   static size_t bucket_of(uint64_t value) {
+      if (value < SUB_COUNT)
+         return static_cast<size_t>(value);
+
+      size_t magnitude = 63 - static_cast<size_t>(__builtin_clzll(value));
+      if (magnitude > MAX_MAGNITUDE)
+         return NUM_BUCKETS - 1;
+      size_t shift = magnitude - SUB_BITS;
+      return SUB_COUNT + shift * SUB_COUNT + static_cast<size_t>((value >> shift) - SUB_COUNT);
+   }
+
+   // Valore più alto contenuto nel bucket 'index'.
+   static uint64_t bucket_upper(size_t index) {
+      if (index < SUB_COUNT)
+         return index;
+
+      size_t shift = (index - SUB_COUNT) / SUB_COUNT;
+      uint64_t sub = SUB_COUNT + (index - SUB_COUNT) % SUB_COUNT;
+      return ((sub + 1) << shift) - 1;
+   }
+
+   std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+   std::atomic<size_t> count_{0};
+   std::atomic<uint64_t> max_{0};
+};
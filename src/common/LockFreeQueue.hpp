@@ -0,0 +1,179 @@
+#pragma once
+
+#include "IQueue.hpp"
+#include "WaitStrategy.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+/**
+ * @brief Code lock-free limitate basate su ring buffer, intercambiabili con BlockingQueue.
+ *
+ * - SpscQueue: un solo producer e un solo consumer (es. producer -> consumer di ff_node_acc_t).
+ * - MpmcQueue: più producer e più consumer (coda di Vyukov), per i casi di fan-in.
+ *
+ * La politica di attesa (BusySpinWait, SpinYieldWait, SpinParkWait) decide cosa fare quando la
+ * coda è vuota o piena. La capacità viene arrotondata alla potenza di 2 successiva.
+ */
+
+// Dimensione di una linea di cache, usata per separare gli indici di producer e consumer ed
+// evitare il false sharing.
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+inline size_t round_up_pow2(size_t value) {
+   size_t pow2 = 2;
+   while (pow2 < value)
+      pow2 <<= 1;
+   return pow2;
+}
+
+/**
+ * @brief Coda Single-Producer / Single-Consumer (algoritmo di Lamport con indici in cache).
+ */
+template <typename T, typename Wait = SpinParkWait> class SpscQueue : public IQueue<T> {
+ public:
+   explicit SpscQueue(size_t capacity)
+       : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1),
+         buffer_(std::make_unique<T[]>(capacity_)) {}
+
+   void push(T value) override {
+      const size_t tail = tail_.load(std::memory_order_relaxed);
+
+      // Rilegge l'indice del consumer solo quando la copia locale dice che la coda è piena.
+      if (tail - head_cache_ == capacity_) {
+         not_full_.wait([&] {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            return tail - head_cache_ < capacity_;
+         });
+      }
+
+      buffer_[tail & mask_] = std::move(value);
+      tail_.store(tail + 1, std::memory_order_release);
+      not_empty_.notify();
+   }
+
+   T pop() override {
+      const size_t head = head_.load(std::memory_order_relaxed);
+
+      // Rilegge l'indice del producer solo quando la copia locale dice che la coda è vuota.
+      if (head == tail_cache_) {
+         not_empty_.wait([&] {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            return head != tail_cache_;
+         });
+      }
+
+      T item = std::move(buffer_[head & mask_]);
+      head_.store(head + 1, std::memory_order_release);
+      not_full_.notify();
+      return item;
+   }
+
+ private:
+   const size_t capacity_;
+   const size_t mask_;
+   std::unique_ptr<T[]> buffer_;
+
+   // Lato consumer.
+   alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+   size_t tail_cache_{0};
+
+   // Lato producer.
+   alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+   size_t head_cache_{0};
+
+   alignas(CACHE_LINE_SIZE) Wait not_empty_;
+   alignas(CACHE_LINE_SIZE) Wait not_full_;
+};
+
+/**
+ * @brief Coda Multi-Producer / Multi-Consumer limitata (algoritmo di Dmitry Vyukov).
+ *
+ * Ogni cella ha un numero di sequenza che indica se è libera per il producer o pronta per il
+ * consumer del giro corrente, così producer e consumer si coordinano con una sola CAS.
+ */
+template <typename T, typename Wait = SpinParkWait> class MpmcQueue : public IQueue<T> {
+ public:
+   explicit MpmcQueue(size_t capacity)
+       : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1),
+         cells_(std::make_unique<Cell[]>(capacity_)) {
+      for (size_t i = 0; i < capacity_; ++i)
+         cells_[i].sequence.store(i, std::memory_order_relaxed);
+   }
+
+   void push(T value) override {
+      if (!try_push(value))
+         not_full_.wait([&] { return try_push(value); });
+      not_empty_.notify();
+   }
+
+   T pop() override {
+      T item;
+      if (!try_pop(item))
+         not_empty_.wait([&] { return try_pop(item); });
+      not_full_.notify();
+      return item;
+   }
+
+   // Tenta l'inserimento senza attendere. Sposta 'value' solo in caso di successo.
+   bool try_push(T &value) {
+      size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+      while (true) {
+         Cell &cell = cells_[pos & mask_];
+         size_t seq = cell.sequence.load(std::memory_order_acquire);
+         auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+         if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+               cell.data = std::move(value);
+               cell.sequence.store(pos + 1, std::memory_order_release);
+               return true;
+            }
+         } else if (diff < 0) {
+            return false; // Coda piena
+         } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+   // Tenta l'estrazione senza attendere.
+   bool try_pop(T &item) {
+      size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+      while (true) {
+         Cell &cell = cells_[pos & mask_];
+         size_t seq = cell.sequence.load(std::memory_order_acquire);
+         auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+         if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+               item = std::move(cell.data);
+               cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+               return true;
+            }
+         } else if (diff < 0) {
+            return false; // Coda vuota
+         } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+         }
+      }
+   }
+
+ private:
+   struct Cell {
+      std::atomic<size_t> sequence;
+      T data;
+   };
+
+   const size_t capacity_;
+   const size_t mask_;
+   std::unique_ptr<Cell[]> cells_;
+
+   alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+   alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+
+   alignas(CACHE_LINE_SIZE) Wait not_empty_;
+   alignas(CACHE_LINE_SIZE) Wait not_full_;
+};
@@ -1,4 +1,7 @@
 #pragma once
+#include "ComputeResult.hpp"
+
+#include <array>
 #include <cstddef>
 
 /**
@@ -12,4 +15,31 @@ struct PerformanceData {
    double avg_overhead_ms = 0.0;
    double throughput = 0.0;
    double elapsed_s = 0.0;
+
+   // Occupazione di ogni stadio della pipeline interna (frazione del tempo totale in cui lo
+   // stadio sta lavorando) e tempo medio per task speso nello stadio.
+   std::array<double, NUM_STAGES> stage_occupancy{};
+   std::array<double, NUM_STAGES> stage_avg_busy_ms{};
+   double avg_buffer_wait_ms = 0.0;
+   size_t buffer_sets_peak = 0;
+   size_t buffer_sets_final = 0;
+
+   // Tempi medi per lancio misurati sul device (vedi DeviceTime), con profiled_launches > 0.
+   std::array<double, NUM_DEVICE_TIMES> avg_device_ms{};
+   size_t profiled_launches = 0;
+
+   // Percentili delle latenze per task (vedi ComputeResult).
+   LatencyPercentiles in_node_latency;
+   LatencyPercentiles computed_latency;
+   LatencyPercentiles inter_completion_latency;
+
+   // Avvio degli acceleratori, warm-up, compilazione dei programmi OpenCL e latenza del primo
+   // task (vedi ComputeResult).
+   double startup_ms = 0.0;
+   double warmup_ms = 0.0;
+   size_t warmup_tasks = 0;
+   double program_build_ms = 0.0;
+   size_t programs_cached = 0;
+   size_t programs_compiled = 0;
+   double first_task_ms = 0.0;
 };
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "BlockingQueue.hpp"
+#include "IQueue.hpp"
+#include "LockFreeQueue.hpp"
+#include "RunConfig.hpp"
+
+#include <memory>
+
+/**
+ * @brief Crea la coda richiesta combinando a runtime tipo di coda e politica di attesa.
+ *
+ * La BlockingQueue ignora la politica di attesa, con capacity = 0 resta illimitata.
+ */
+template <typename T>
+std::unique_ptr<IQueue<T>> make_queue(QueueKind kind, WaitKind wait, size_t capacity) {
+   if (kind == QueueKind::Blocking)
+      return std::make_unique<BlockingQueue<T>>(capacity);
+
+   if (kind == QueueKind::Spsc) {
+      switch (wait) {
+      case WaitKind::BusySpin:
+         return std::make_unique<SpscQueue<T, BusySpinWait>>(capacity);
+      case WaitKind::SpinYield:
+         return std::make_unique<SpscQueue<T, SpinYieldWait>>(capacity);
+      case WaitKind::SpinPark:
+         return std::make_unique<SpscQueue<T, SpinParkWait>>(capacity);
+      }
+   }
+
+   switch (wait) {
+   case WaitKind::BusySpin:
+      return std::make_unique<MpmcQueue<T, BusySpinWait>>(capacity);
+   case WaitKind::SpinYield:
+      return std::make_unique<MpmcQueue<T, SpinYieldWait>>(capacity);
+   case WaitKind::SpinPark:
+   default:
+      return std::make_unique<MpmcQueue<T, SpinParkWait>>(capacity);
+   }
+}
+
+/**
+ * @brief Variante che legge tipo, politica e capacità dalla configurazione di esecuzione.
+ * Se pipeline_depth è impostata limita ogni coda a quel numero di task, altrimenti la
+ * BlockingQueue resta illimitata come nella versione originale del nodo.
+ */
+template <typename T> std::unique_ptr<IQueue<T>> make_queue(const RunConfig &config) {
+   size_t capacity = config.pipeline_depth;
+   if (capacity == 0 && config.queue_kind != QueueKind::Blocking)
+      capacity = config.queue_capacity;
+
+   return make_queue<T>(config.queue_kind, config.wait_kind, capacity);
+}
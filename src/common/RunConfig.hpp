@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @brief Tipo di coda usata tra gli stadi della pipeline interna di ff_node_acc_t.
+ */
+enum class QueueKind {
+   Blocking, // BlockingQueue (mutex + condition variable)
+   Spsc,     // SpscQueue lock-free (un producer, un consumer)
+   Mpmc      // MpmcQueue lock-free (più producer, più consumer)
+};
+
+/**
+ * @brief Politica di attesa delle code lock-free quando sono vuote o piene.
+ */
+enum class WaitKind {
+   BusySpin,  // Attesa attiva pura
+   SpinYield, // Spin, poi yield del thread
+   SpinPark   // Spin, yield e infine sospensione su condition variable
+};
+
+/**
+ * @brief Come vengono assegnati i worker di una farm di acceleratori OpenCL ai dispositivi.
+ */
+enum class FarmMode {
+   Device, // Un worker per dispositivo (a rotazione se i worker sono più dei dispositivi)
+   Queue   // Tutti i worker sullo stesso dispositivo, ognuno con la propria coda di comandi
+};
+
+/**
+ * @brief Tipo di dispositivo OpenCL cercato da Gpu_OpenCL_Accelerator.
+ */
+enum class OpenClDeviceKind { Gpu, Cpu, Accelerator, All };
+
+/**
+ * @brief Code di comandi usate da Gpu_OpenCL_Accelerator e Fpga_Accelerator.
+ */
+enum class ClQueueMode {
+   InOrder,    // Una coda in-order per upload, kernel e download
+   OutOfOrder, // Una coda out-of-order, ordinata solo dagli eventi
+   Split       // Tre code in-order: upload, kernel, download
+};
+
+/**
+ * @brief Uso della memoria dell'host da parte di Gpu_OpenCL_Accelerator e Fpga_Accelerator.
+ */
+enum class MemMode {
+   Copy,    // Buffer sul device, scritti e letti dai vettori del task
+   Pinned,  // Come Copy, ma i vettori dei task vengono fissati in memoria (mappati)
+   ZeroCopy // Buffer CL_MEM_USE_HOST_PTR sui vettori del task, sincronizzati con map/unmap
+};
+
+/**
+ * @brief Come lo stadio di Download di ff_node_acc_t attende i risultati dei task.
+ */
+enum class CompletionMode {
+   Blocking, // Download bloccante di un task alla volta, nell'ordine di lancio
+   Callback  // Download accodato dopo il kernel, il task finito arriva con una callback
+};
+
+/**
+ * @brief Set di istruzioni vettoriali dei kernel CPU (vedi SimdKernels), in ordine di
+ * ampiezza.
+ */
+enum class SimdMode {
+   Off,    // Kernel scalari (vettorizzati solo dal compilatore)
+   Sse42,  // Registri a 128 bit
+   Avx2,   // Registri a 256 bit
+   Avx512, // Registri a 512 bit
+   Auto    // Il più ampio supportato dalla CPU
+};
+
+/**
+ * @brief Lettura degli input dei task dal file sorgente (vedi FileSource).
+ */
+enum class SourceMode {
+   Mmap,    // File mappato in memoria, i task puntano direttamente alla mappatura
+   Prefetch // Un thread di I/O legge con pread i task successivi nei vettori del pool
+};
+
+/**
+ * @brief Formato dei risultati scritti a fine esecuzione.
+ */
+enum class OutputFormat {
+   Text, // Metriche leggibili su stdout (print_metrics)
+   Json, // Un oggetto JSON su una riga con risultati, configurazione e ambiente
+   Csv   // Come Json, ma come riga CSV preceduta dall'intestazione
+};
+
+/**
+ * @brief Opzioni facoltative di esecuzione, lette dagli argomenti '--chiave=valore' della riga
+ * di comando. I valori di default riproducono il comportamento originale del programma.
+ */
+struct RunConfig {
+   QueueKind queue_kind = QueueKind::Blocking;
+   WaitKind wait_kind = WaitKind::SpinPark;
+   size_t queue_capacity = 1024; // Capacità delle code limitate
+
+   // Pipeline interna di ff_node_acc_t: 2 thread (upload+launch, download) oppure 3 thread
+   // (upload, launch, download). pipeline_depth > 0 limita i task in coda fra uno stadio e il
+   // successivo, 0 lascia la capacità di default delle code.
+   size_t acc_stages = 2;
+   size_t pipeline_depth = 0;
+
+   // Attesa dei risultati nello stadio di Download di ff_node_acc_t.
+   CompletionMode completion = CompletionMode::Blocking;
+
+   // Farm di nodi ff_node_acc_t (gpu_opencl): numero di worker (0 = uno per dispositivo,
+   // 1 = pipeline con un solo nodo) e loro assegnazione ai dispositivi.
+   size_t acc_workers = 1;
+   FarmMode farm_mode = FarmMode::Device;
+   OpenClDeviceKind cl_device_kind = OpenClDeviceKind::Gpu;
+
+   // Farm ibrida (hybrid): worker CPU affiancati agli acceleratori, thread del ParallelFor di
+   // ognuno (0 = divide fra i worker CPU i core non usati dai nodi acceleratore) e massimo
+   // numero di task in volo per ogni worker acceleratore (default: pool di 3 buffer set + 1).
+   // cpu_ff_stream usa gli stessi worker e thread CPU, senza acceleratori; cpu_thread usa
+   // cpu_threads come numero di thread del device (Cpu_Thread_Accelerator).
+   size_t cpu_workers = 1;
+   size_t cpu_threads = 0;
+   size_t acc_max_in_flight = 4;
+
+   // Esecuzione a chunk (gpu_opencl, fpga): numero di elementi per chunk, 0 = task intero.
+   size_t chunk_size = 0;
+
+   // Code di comandi OpenCL (gpu_opencl, fpga): con out_of_order o split l'upload di un task
+   // si sovrappone al kernel del precedente e il download al kernel del successivo.
+   ClQueueMode cl_queue_mode = ClQueueMode::InOrder;
+
+   // Memoria dell'host usata per i trasferimenti (gpu_opencl, fpga).
+   MemMode mem_mode = MemMode::Copy;
+
+   // Profiling OpenCL (gpu_opencl, fpga): code create con CL_QUEUE_PROFILING_ENABLE e tempi di
+   // upload, kernel e download di ogni task letti dagli eventi.
+   bool profile = false;
+
+   // Pool di buffer set (gpu_opencl, fpga): numero di set (0 = auto, si adatta all'attesa dei
+   // set liberi) e memoria del device a disposizione del pool (0 = 3/4 della memoria globale).
+   size_t pool_size = 0;
+   size_t mem_budget_mb = 0;
+   // Set massimi del pool di buffer di un acceleratore OpenCL, qualunque sia pool_size.
+   static constexpr size_t MAX_POOL_SETS = 32;
+
+   // Dimensione dei task: N della riga di comando (per preallocare il pool di buffer) e numero
+   // di dimensioni diverse generate dall'Emitter (N, N/2, ..., N/2^(mixed_n-1), a rotazione).
+   size_t expected_n = 0;
+   size_t mixed_n = 1;
+
+   // Batching dei task piccoli davanti a ff_node_acc_t: task per batch (1 = disattivato),
+   // dimensione scelta in base a N (batch_auto) e attesa massima del primo task del batch.
+   size_t batch_size = 1;
+   bool batch_auto = false;
+   size_t batch_timeout_us = 1000;
+
+   // Pool di task dell'Emitter (vedi TaskPool): ogni task ha i propri vettori e viene
+   // riciclato al completamento. task_pool_slots = 0 sceglie il numero di slot in base a N;
+   // con task_pool = false i task, allocati con new, condividono gli stessi vettori.
+   bool task_pool = true;
+   size_t task_pool_slots = 0;
+
+   // Stream su file (vedi FileSource e FileSink): file binario con gli input dei task (vuoto =
+   // dati generati dall'Emitter), modo di lettura, task letti in anticipo e file in cui
+   // scrivere l'output dei task (vuoto = risultati scartati).
+   std::string source_path;
+   SourceMode source_mode = SourceMode::Mmap;
+   size_t read_ahead = 4;
+   std::string sink_path;
+
+   // File in cui scrivere la timeline dei task (Chrome Trace Event JSON), vuoto = nessuna
+   // traccia.
+   std::string trace_path;
+
+   // Kernel CPU (cpu_ff, cpu_ff_stream, cpu_omp, cpu_thread e worker CPU di hybrid): versioni
+   // vettoriali esplicite.
+   SimdMode simd = SimdMode::Auto;
+
+   // Task eseguiti da ogni acceleratore dopo l'inizializzazione e prima dell'avvio della
+   // misura, esclusi dalle statistiche (primi accessi alla memoria, compilazione JIT, ecc.).
+   size_t warmup_tasks = 0;
+
+   // Cartella della cache dei programmi OpenCL compilati (vedi ProgramCache), vuota = nessuna
+   // cache. Di default $HOME/.cache/tesi-exec.
+   std::string kernel_cache_dir = default_kernel_cache_dir();
+
+   // Risultati in formato leggibile o strutturato, e file a cui aggiungerli (vuoto = stdout,
+   // al posto delle metriche leggibili).
+   OutputFormat output_format = OutputFormat::Text;
+   std::string output_path;
+
+   static std::string default_kernel_cache_dir() {
+      const char *home = std::getenv("HOME");
+      return (home && *home) ? std::string(home) + "/.cache/tesi-exec" : "";
+   }
+};
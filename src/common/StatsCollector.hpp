@@ -1,17 +1,144 @@
 #pragma once
 
+#include "ComputeResult.hpp"
+#include "LatencyHistogram.hpp"
+
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <future>
 
 /**
- * @brief Struttura usata per raccogliere risultati generati dai 2 thread interni del nodo
+ * @brief Struttura usata per raccogliere risultati generati dai thread interni del nodo
  * ff_node_acc_t e passarli al thread principale di FF in nella strategia di esecuzione
  * AcceleratorPipelineRunner.
+ *
+ * Può essere condivisa da più nodi ff_node_acc_t (farm): il conteggio finale viene comunicato
+ * dall'ultimo Consumer che termina e il tempo tra due completamenti è misurato globalmente.
+ * Anche i worker CPU della farm ibrida (ff_node_cpu_t) aggiornano le stesse statistiche.
+ *
+ * Oltre alle somme (per le medie) registra ogni latenza in un LatencyHistogram, per i
+ * percentili: le medie nascondono gli stalli dei singoli task (es. attesa di un buffer set).
  */
 struct StatsCollector {
    std::atomic<size_t> tasks_processed{0};
    std::promise<size_t> count_promise;
+   std::atomic<size_t> active_consumers{1};      // Consumer ancora attivi (uno per nodo)
+   std::atomic<long long> last_completion_ns{-1}; // Istante dell'ultimo completamento
    std::atomic<long long> computed_ns{0};
    std::atomic<long long> total_InNode_time_ns{0};
    std::atomic<long long> inter_completion_time_ns{0};
+
+   // Distribuzioni per task delle stesse latenze.
+   LatencyHistogram in_node_hist;
+   LatencyHistogram computed_hist;
+   LatencyHistogram inter_completion_hist;
+
+   // Tempo di lavoro e di attesa per ogni stadio della pipeline interna.
+   std::array<std::atomic<long long>, NUM_STAGES> stage_busy_ns{};
+   std::array<std::atomic<long long>, NUM_STAGES> stage_wait_ns{};
+   std::atomic<long long> buffer_wait_ns{0};
+
+   // Tempi sul device dei lanci profilati (RunConfig::profile).
+   std::array<std::atomic<long long>, NUM_DEVICE_TIMES> device_ns{};
+   std::atomic<size_t> profiled_launches{0};
+
+   // Inizializzazione e warm-up più lunghi fra gli acceleratori (i nodi di una farm si
+   // avviano in parallelo) e istante del primo completamento.
+   std::atomic<long long> startup_ns{0};
+   std::atomic<long long> warmup_ns{0};
+   std::atomic<long long> first_completion_ns{-1};
+
+   /**
+    * @brief Registra il completamento di un task entrato nel nodo in 'arrival' e terminato in
+    * 'end', con 'task_computed_ns' di puro calcolo.
+    */
+   void record_task(std::chrono::steady_clock::time_point arrival,
+                    std::chrono::steady_clock::time_point end, long long task_computed_ns) {
+      // Tempo dall'ultimo completamento (di questo o di un altro nodo della farm).
+      long long end_ns =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(end.time_since_epoch()).count();
+      long long no_completion = -1;
+      first_completion_ns.compare_exchange_strong(no_completion, end_ns);
+      long long last_ns = last_completion_ns.exchange(end_ns);
+      if (last_ns >= 0) {
+         inter_completion_time_ns += end_ns - last_ns;
+         inter_completion_hist.record(end_ns - last_ns);
+      }
+
+      long long in_node_ns =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(end - arrival).count();
+      computed_ns += task_computed_ns;
+      total_InNode_time_ns += in_node_ns;
+      computed_hist.record(task_computed_ns);
+      in_node_hist.record(in_node_ns);
+      tasks_processed++;
+   }
+
+   /**
+    * @brief Registra i tempi sul device di un lancio (un task o un batch).
+    */
+   void record_device_times(const std::array<long long, NUM_DEVICE_TIMES> &launch_ns) {
+      for (size_t t = 0; t < NUM_DEVICE_TIMES; ++t)
+         device_ns[t] += launch_ns[t];
+      profiled_launches++;
+   }
+
+   /**
+    * @brief Registra la durata dell'inizializzazione e del warm-up di un acceleratore.
+    */
+   void record_startup(long long init_ns, long long warmup_task_ns) {
+      store_max(startup_ns, init_ns);
+      store_max(warmup_ns, warmup_task_ns);
+   }
+
+   /**
+    * @brief Chiamata da ogni nodo quando termina: l'ultimo comunica il conteggio finale.
+    */
+   void consumer_finished() {
+      if (active_consumers.fetch_sub(1) == 1)
+         count_promise.set_value(tasks_processed.load());
+   }
+
+   /**
+    * @brief Copia le statistiche raccolte nel risultato finale.
+    */
+   void fill_result(ComputeResult &res) const {
+      res.computed_ns = computed_ns.load();
+      res.total_InNode_time_ns = total_InNode_time_ns.load();
+      res.inter_completion_time_ns = inter_completion_time_ns.load();
+      for (size_t s = 0; s < NUM_STAGES; ++s) {
+         res.stage_busy_ns[s] = stage_busy_ns[s].load();
+         res.stage_wait_ns[s] = stage_wait_ns[s].load();
+      }
+      res.buffer_wait_ns = buffer_wait_ns.load();
+      for (size_t t = 0; t < NUM_DEVICE_TIMES; ++t)
+         res.device_ns[t] = device_ns[t].load();
+      res.profiled_launches = profiled_launches.load();
+      res.startup_ns = startup_ns.load();
+      res.warmup_ns = warmup_ns.load();
+      res.in_node_latency = in_node_hist.summary();
+      res.computed_latency = computed_hist.summary();
+      res.inter_completion_latency = inter_completion_hist.summary();
+   }
+
+   /**
+    * @brief Tempo da 'start' (avvio della pipeline) al completamento del primo task, 0 se
+    * nessun task è stato completato.
+    */
+   long long first_task_ns(std::chrono::steady_clock::time_point start) const {
+      long long first_ns = first_completion_ns.load();
+      if (first_ns < 0)
+         return 0;
+      return first_ns -
+             std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch())
+                .count();
+   }
+
+ private:
+   static void store_max(std::atomic<long long> &target, long long value) {
+      long long current = target.load();
+      while (value > current && !target.compare_exchange_weak(current, value)) {
+      }
+   }
 };
\ No newline at end of file
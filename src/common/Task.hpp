@@ -1,6 +1,12 @@
 #pragma once
+#include "AlignedAllocator.hpp"
+#include "ComputeResult.hpp"
+
+#include <array>
 #include <chrono>
 #include <cstddef>
+#include <memory>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -8,6 +14,19 @@
 #include <CL/cl.h>
 #endif
 
+struct Task;
+class TaskPool;
+
+/**
+ * Dati di un batch: più task piccoli raggruppati dal TaskBatcher in un unico task, i cui
+ * vettori contigui vengono processati con un solo lancio del kernel.
+ */
+struct TaskBatch {
+   std::vector<Task *> members; // Task originali, nell'ordine in cui compaiono nel batch
+   std::vector<size_t> offsets; // Offset di ogni membro nei vettori del batch
+   HostVector<int> a, b, c;     // Vettori contigui del batch sull'host
+};
+
 /**
  * Struttura che rappresenta un singolo task di calcolo.
  */
@@ -19,9 +38,27 @@ struct Task {
 
    // Ultimo evento OpenCL generato (usato con GPU_openCL e FPGA).
    cl_event event{nullptr};
-   // Handle generico per la sincronizzazione con GPU_Metal.
+   // Con l'esecuzione a chunk, ultimo evento generato per ogni chunk e sub-buffer creati per
+   // il task (solo FPGA), rilasciati al termine del download.
+   std::vector<cl_event> chunk_events;
+   std::vector<cl_mem> chunk_buffers;
+   // Handle generico per la sincronizzazione con GPU_Metal e Cpu_Thread_Accelerator.
    void *sync_handle{nullptr};
+   // Con il download asincrono, tempo fra l'accodamento del download e il suo completamento.
+   long long computed_ns{0};
+   // Con il profiling OpenCL, eventi dei comandi di upload, kernel e download del task (indici
+   // DEVICE_H2D, DEVICE_KERNEL, DEVICE_D2H) e tempi sul device letti al termine del download.
+   std::array<std::vector<cl_event>, 3> profile_events;
+   std::array<long long, NUM_DEVICE_TIMES> device_ns{};
+   bool profiled{false};
 
    // Tempo di arrivo del task nel nodo.
    std::chrono::steady_clock::time_point arrival_time;
+
+   // Se il task è un batch, i task che contiene (nullptr per un task normale).
+   std::unique_ptr<TaskBatch> batch;
+
+   // Pool a cui restituire il task al completamento (nullptr = allocato con new, vedi
+   // release_task).
+   TaskPool *pool{nullptr};
 };
\ No newline at end of file
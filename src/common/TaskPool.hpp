@@ -0,0 +1,141 @@
+#pragma once
+
+#include "AlignedAllocator.hpp"
+#include "LockFreeQueue.hpp"
+#include "RunConfig.hpp"
+#include "Task.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief Pool di oggetti Task preallocati e riciclati, ognuno con i propri vettori di
+ * input/output.
+ *
+ * Ogni slot possiede uno slab allineato alla pagina con i vettori a, b e c del task (ognuno
+ * inizia su una pagina nuova), inizializzati alla costruzione: i task in volo non scrivono più
+ * tutti sullo stesso vettore c e cache e trasferimenti vedono dati distinti per ogni task.
+ *
+ * L'Emitter (o il FileSource) acquisisce uno slot per ogni task e lo riempie, chi completa il
+ * task lo restituisce con release_task(): il nodo ff_node_acc_t dal suo thread Consumer (anche
+ * per i task di un batch), ff_node_cpu_t o il FileSink. Il canale di ritorno è una MpmcQueue
+ * (più thread restituiscono, l'Emitter acquisisce), quindi a regime l'Emitter non alloca
+ * nulla; se tutti gli slot sono in volo l'Emitter attende, limitando i task in memoria.
+ */
+class TaskPool {
+ public:
+   // Memoria dei vettori del pool con RunConfig::task_pool_slots = 0 (auto).
+   static constexpr size_t AUTO_BUDGET_BYTES = size_t(1) << 30;
+   // Slot minimi in auto: restano task da generare anche con tutti gli stadi occupati.
+   static constexpr size_t MIN_SLOTS = 8;
+
+   /**
+    * @param slots Numero di task (e di slab) del pool.
+    * @param n Elementi di ogni vettore.
+    * @param own_inputs Con false lo slab contiene solo il vettore c: gli input vengono
+    * assegnati da chi acquisisce il task (FileSource in modalità mmap).
+    */
+   TaskPool(size_t slots, size_t n, bool own_inputs = true)
+       : stride_(round_to_page(n)), tasks_(slots), slabs_(slots), free_(slots) {
+      const size_t vectors = own_inputs ? 3 : 1;
+      for (size_t s = 0; s < slots; ++s) {
+         slabs_[s].resize(vectors * stride_);
+         int *slab = slabs_[s].data();
+         for (size_t i = 0; own_inputs && i < n; ++i) {
+            slab[i] = int(i);
+            slab[stride_ + i] = int(2 * i);
+         }
+
+         Task &task = tasks_[s];
+         task.a = own_inputs ? slab : nullptr;
+         task.b = own_inputs ? slab + stride_ : nullptr;
+         task.c = slab + (vectors - 1) * stride_;
+         task.pool = this;
+         Task *slot = &task;
+         free_.push(slot);
+      }
+   }
+
+   /**
+    * @brief Pool di contenitori di batch per il TaskBatcher: ogni slot ha un TaskBatch, i cui
+    * vettori crescono fino al batch più grande e poi vengono riusati. I task non hanno slab.
+    */
+   struct BatchSlots {};
+   TaskPool(size_t slots, BatchSlots) : stride_(0), tasks_(slots), free_(slots) {
+      for (Task &task : tasks_) {
+         task.batch = std::make_unique<TaskBatch>();
+         task.pool = this;
+         Task *slot = &task;
+         free_.push(slot);
+      }
+   }
+
+   /**
+    * @brief Acquisisce un task libero, attendendo che ne venga restituito uno se sono tutti in
+    * volo. I campi di stato del task precedente vengono azzerati, senza liberare la capacità
+    * dei vettori (chunk ed eventi di profiling) né il TaskBatch di un contenitore di batch.
+    */
+   Task *acquire() {
+      Task *task = free_.pop();
+      task->buffer_idx = 0;
+      task->event = nullptr;
+      task->chunk_events.clear();
+      task->chunk_buffers.clear();
+      task->sync_handle = nullptr;
+      task->computed_ns = 0;
+      for (auto &events : task->profile_events)
+         events.clear();
+      task->device_ns = {};
+      task->profiled = false;
+      task->arrival_time = {};
+      return task;
+   }
+
+   // Restituisce un task al pool. Può essere chiamata da qualsiasi thread.
+   void release(Task *task) { free_.push(task); }
+
+   size_t slots() const { return tasks_.size(); }
+
+   /**
+    * @brief Numero di slot per task di n elementi: quelli richiesti, o in auto quelli che
+    * stanno in AUTO_BUDGET_BYTES, almeno MIN_SLOTS e due batch. Mai più dei task da generare
+    * né meno di un batch più uno: il batch in costruzione trattiene i suoi task, se fossero
+    * tutti gli slot l'Emitter non potrebbe completarlo.
+    * @param batch_tasks Task per batch del TaskBatcher (1 senza batching).
+    */
+   static size_t slots_for(const RunConfig &config, size_t n, size_t num_tasks,
+                           size_t batch_tasks = 1) {
+      size_t slots = config.task_pool_slots;
+      if (slots == 0) {
+         size_t slot_bytes = 3 * round_to_page(n) * sizeof(int);
+         size_t min_slots = std::max(MIN_SLOTS, 2 * batch_tasks + 2);
+         slots = std::max(AUTO_BUDGET_BYTES / slot_bytes, min_slots);
+      }
+      slots = std::max(slots, batch_tasks + 1);
+      return std::max<size_t>(std::min(slots, num_tasks), 1);
+   }
+
+ private:
+   // Elementi arrotondati a un multiplo di una pagina, così ogni vettore dello slab è
+   // allineato alla pagina.
+   static size_t round_to_page(size_t n) {
+      constexpr size_t page_elems = 4096 / sizeof(int);
+      return std::max<size_t>((n + page_elems - 1) / page_elems, 1) * page_elems;
+   }
+
+   size_t stride_;
+   std::vector<Task> tasks_;
+   std::vector<HostVector<int>> slabs_;
+   MpmcQueue<Task *> free_;
+};
+
+/**
+ * @brief Rilascia un task completato: lo restituisce al suo pool o, se non ne ha uno (task
+ * allocati con new), lo distrugge.
+ */
+inline void release_task(Task *task) {
+   if (task->pool)
+      task->pool->release(task);
+   else
+      delete task;
+}
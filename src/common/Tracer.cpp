@@ -0,0 +1,82 @@
+#include "Tracer.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+std::mutex Tracer::registry_mutex_;
+std::vector<std::unique_ptr<Tracer::ThreadBuffer>> Tracer::registry_;
+std::string Tracer::path_;
+
+void Tracer::start(const std::string &path) {
+   path_ = path;
+   origin_ = Clock::now();
+   enabled_ = true;
+}
+
+Tracer::ThreadBuffer *Tracer::register_thread() {
+   auto buffer = std::make_unique<ThreadBuffer>();
+   buffer->events.resize(THREAD_CAPACITY);
+
+   std::lock_guard<std::mutex> lock(registry_mutex_);
+   buffer->tid = static_cast<uint32_t>(registry_.size() + 1);
+   registry_.push_back(std::move(buffer));
+   return registry_.back().get();
+}
+
+/**
+ * Formato Chrome Trace Event: un oggetto con l'array 'traceEvents'. Gli intervalli sono eventi
+ * 'X' (inizio e durata), gli istanti eventi 'i' con scope di thread, i nomi dei thread eventi
+ * di metadati 'M'. I tempi sono in µs, con la parte decimale per non perdere i ns.
+ */
+void Tracer::dump() {
+   if (!enabled_)
+      return;
+
+   FILE *out = std::fopen(path_.c_str(), "w");
+   if (!out) {
+      std::cerr << "[ERROR] Tracer: cannot open '" << path_ << "' for writing.\n";
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock(registry_mutex_);
+   uint64_t total = 0, dropped = 0;
+   const char *sep = "\n";
+
+   std::fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+   for (const auto &buffer : registry_) {
+      std::fprintf(out,
+                   "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                   "\"args\":{\"name\":\"%s %u\"}}",
+                   sep, buffer->tid, buffer->name ? buffer->name : "Thread", buffer->tid);
+      sep = ",\n";
+
+      // Con il buffer pieno il più vecchio degli eventi rimasti è quello che segue l'ultimo
+      // scritto.
+      uint64_t kept = buffer->written < THREAD_CAPACITY ? buffer->written : THREAD_CAPACITY;
+      uint64_t first = buffer->written - kept;
+      total += kept;
+      dropped += first;
+
+      for (uint64_t i = first; i < buffer->written; ++i) {
+         const Event &e = buffer->events[i % THREAD_CAPACITY];
+         std::fprintf(out, "%s{\"name\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", sep, e.name,
+                      buffer->tid, e.start_ns / 1.0e3);
+         if (e.dur_ns < 0)
+            std::fprintf(out, ",\"ph\":\"i\",\"s\":\"t\"");
+         else
+            std::fprintf(out, ",\"ph\":\"X\",\"dur\":%.3f", e.dur_ns / 1.0e3);
+         if (e.task_id != NO_TASK)
+            std::fprintf(out, ",\"args\":{\"task\":%llu}",
+                         static_cast<unsigned long long>(e.task_id));
+         std::fprintf(out, "}");
+      }
+   }
+   std::fprintf(out, "\n]}\n");
+   std::fclose(out);
+
+   std::cout << "[Tracer] " << total << " events from " << registry_.size()
+             << " threads written to '" << path_ << "'";
+   if (dropped > 0)
+      std::cout << " (" << dropped << " oldest events overwritten)";
+   std::cout << ".\n";
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Tracciamento facoltativo (RunConfig::trace_path) della timeline dei task, esportata
+ * in formato Chrome Trace Event JSON e apribile con Perfetto (ui.perfetto.dev) o
+ * chrome://tracing.
+ *
+ * Ogni thread registra i propri eventi in un buffer circolare di capacità fissa, creato al
+ * primo evento del thread: la registrazione non prende lock né alloca memoria, e se il buffer
+ * si riempie vengono sovrascritti gli eventi più vecchi. Con il tracciamento disattivato ogni
+ * chiamata si riduce al controllo di un flag.
+ *
+ * Il tracciamento va attivato con start() prima dell'avvio dei thread, e i buffer vanno letti
+ * con dump() dopo la loro terminazione (a fine execute() dei runner).
+ */
+class Tracer {
+ public:
+   using Clock = std::chrono::steady_clock;
+
+   // Eventi conservati per thread (32 byte l'uno).
+   static constexpr size_t THREAD_CAPACITY = size_t(1) << 16;
+
+   // Id di task per gli eventi che non riguardano un task.
+   static constexpr uint64_t NO_TASK = UINT64_MAX;
+
+   /**
+    * @brief Attiva il tracciamento. Il file viene scritto da dump() in 'path'.
+    */
+   static void start(const std::string &path);
+
+   static bool enabled() { return enabled_; }
+
+   /**
+    * @brief Nome con cui il thread chiamante compare nella traccia. La stringa deve restare
+    * valida fino a dump().
+    */
+   static void set_thread_name(const char *name) {
+      if (enabled_)
+         local_buffer()->name = name;
+   }
+
+   /**
+    * @brief Registra un intervallo [from, to] del thread chiamante relativo al task 'task_id'.
+    * 'name' deve restare valido fino a dump() (una stringa letterale).
+    */
+   static void complete(const char *name, uint64_t task_id, Clock::time_point from,
+                        Clock::time_point to) {
+      if (enabled_)
+         local_buffer()->push({name, task_id, to_ns(from - origin_), to_ns(to - from)});
+   }
+
+   /**
+    * @brief Registra un evento istantaneo del thread chiamante relativo al task 'task_id'.
+    */
+   static void instant(const char *name, uint64_t task_id) {
+      if (enabled_)
+         local_buffer()->push({name, task_id, to_ns(Clock::now() - origin_), -1});
+   }
+
+   /**
+    * @brief Scrive la traccia di tutti i thread nel file indicato a start(). Non fa nulla se
+    * il tracciamento non è attivo.
+    */
+   static void dump();
+
+ private:
+   struct Event {
+      const char *name;
+      uint64_t task_id;
+      int64_t start_ns; // Dall'attivazione del tracciamento
+      int64_t dur_ns;   // -1 per gli eventi istantanei
+   };
+
+   // Buffer circolare di un thread, scritto solo dal thread stesso.
+   struct ThreadBuffer {
+      uint32_t tid;
+      const char *name = nullptr;
+      std::vector<Event> events;
+      uint64_t written = 0; // Eventi registrati in totale, anche quelli sovrascritti
+
+      void push(const Event &event) {
+         events[written % THREAD_CAPACITY] = event;
+         ++written;
+      }
+   };
+
+   static int64_t to_ns(Clock::duration d) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+   }
+
+   static ThreadBuffer *local_buffer() {
+      if (!local_)
+         local_ = register_thread();
+      return local_;
+   }
+
+   // Crea e registra il buffer del thread chiamante.
+   static ThreadBuffer *register_thread();
+
+   // Buffer di tutti i thread che hanno registrato eventi. Sopravvivono ai thread, così
+   // dump() può leggerli dopo la loro terminazione.
+   static std::mutex registry_mutex_;
+   static std::vector<std::unique_ptr<ThreadBuffer>> registry_;
+   static std::string path_;
+
+   static inline bool enabled_ = false;
+   static inline Clock::time_point origin_{};
+   static inline thread_local ThreadBuffer *local_ = nullptr;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+/**
+ * @brief Carico di un worker di una farm (nodi ff_node_acc_t o ff_node_cpu_t).
+ *
+ * Lo scheduler della farm incrementa in_flight quando assegna un task al worker, il worker lo
+ * decrementa quando il task è completato. Lo scheduler può così scegliere il worker con meno
+ * task in volo, o con il completamento atteso più vicino, senza canali di ritorno.
+ */
+struct WorkerLoad {
+   std::atomic<size_t> in_flight{0};          // Task assegnati e non ancora completati
+   std::atomic<size_t> completed{0};          // Task completati dal worker
+   std::atomic<long long> ewma_service_ns{0}; // Tempo di servizio osservato (0 = ignoto)
+
+   /**
+    * @brief Chiamata dal worker (un solo thread) al completamento di un task entrato nel nodo
+    * in 'arrival' e terminato in 'end'.
+    *
+    * Il tempo di servizio del task parte dal più recente fra il suo arrivo e il completamento
+    * precedente: per un acceleratore con più task in volo misura quindi l'intervallo fra due
+    * completamenti (l'inverso del throughput del worker), non la latenza del singolo task.
+    */
+   void record_completion(std::chrono::steady_clock::time_point arrival,
+                          std::chrono::steady_clock::time_point end) {
+      auto start = std::max(arrival, last_end_);
+      long long sample =
+         std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+      last_end_ = end;
+
+      long long prev = ewma_service_ns.load(std::memory_order_relaxed);
+      long long next = (prev == 0) ? sample : prev + (sample - prev) / EWMA_WEIGHT;
+      ewma_service_ns.store(std::max(next, 1LL), std::memory_order_relaxed);
+
+      completed.fetch_add(1, std::memory_order_relaxed);
+      in_flight.fetch_sub(1, std::memory_order_release);
+   }
+
+ private:
+   static constexpr long long EWMA_WEIGHT = 4; // Peso del nuovo campione: 1/4
+
+   std::chrono::steady_clock::time_point last_end_{}; // Scritto solo dal worker
+};
@@ -7,9 +7,12 @@
 namespace device {
 
 inline constexpr const char *CPU_FF = "cpu_ff";
+inline constexpr const char *CPU_FF_STREAM = "cpu_ff_stream";
 inline constexpr const char *CPU_OMP = "cpu_omp";
 inline constexpr const char *GPU_CL = "gpu_opencl";
 inline constexpr const char *GPU_MTL = "gpu_metal";
 inline constexpr const char *FPGA = "fpga";
+inline constexpr const char *HYBRID = "hybrid";
+inline constexpr const char *CPU_THREAD = "cpu_thread";
 
 } // namespace device
\ No newline at end of file
@@ -1,50 +1,135 @@
 /**
  * Implementazione della Factory per la creazione di uno specifico DeviceRunner fra
- * CPU FastFlow, CPU OpenMP, GPU OpenCL, GPU Metal, FPGA.
+ * CPU FastFlow (a dati o a stream di task), CPU OpenMP, GPU OpenCL, GPU Metal, FPGA, farm
+ * ibrida CPU + GPU OpenCL e pipeline di offloading sulla CPU dell'host (cpu_thread).
  */
 
 #include "DeviceRunner_Factory.hpp"
 #include "../common/device_types.h"
 
 #include "../strategy_accelerator/AcceleratorPipelineRunner.hpp"
+#include "../strategy_accelerator/accelerator/Cpu_Thread_Accelerator.hpp"
+#include "../strategy_accelerator/accelerator/Gpu_OpenCL_Accelerator.hpp"
 #include "../strategy_cpu/Cpu_FF_Runner.hpp"
+#include "../strategy_cpu/Cpu_FF_Stream_Runner.hpp"
+#include "../strategy_hybrid/HybridFarmRunner.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
 
 #ifdef __APPLE__
 #include "../strategy_accelerator/accelerator/Gpu_Metal_Accelerator.hpp"
-#include "../strategy_accelerator/accelerator/Gpu_OpenCL_Accelerator.hpp"
 #else
 #include "../strategy_accelerator/accelerator/Fpga_Accelerator.hpp"
 #include "../strategy_cpu/Cpu_OMP_Runner.hpp"
 #endif
 
+/**
+ * Traduce il tipo di dispositivo OpenCL scelto da riga di comando nella costante OpenCL.
+ */
+static cl_device_type to_cl_device_type(OpenClDeviceKind kind) {
+   switch (kind) {
+   case OpenClDeviceKind::Cpu:
+      return CL_DEVICE_TYPE_CPU;
+   case OpenClDeviceKind::Accelerator:
+      return CL_DEVICE_TYPE_ACCELERATOR;
+   case OpenClDeviceKind::All:
+      return CL_DEVICE_TYPE_ALL;
+   default:
+      return CL_DEVICE_TYPE_GPU;
+   }
+}
+
+/**
+ * Crea gli acceleratori OpenCL, uno per worker della farm (RunConfig::acc_workers, 0 = uno per
+ * dispositivo). In modalità 'device' il worker i usa il dispositivo i (modulo il numero di
+ * dispositivi), in modalità 'queue' tutti i worker usano il primo dispositivo, ognuno con la
+ * propria coda di comandi. I worker sullo stesso dispositivo condividono contesto e programma
+ * e si dividono la sua memoria.
+ */
+static std::vector<std::unique_ptr<IAccelerator>>
+create_opencl_accelerators(const std::string &kernel_path, const std::string &kernel_name,
+                           const RunConfig &config) {
+   cl_device_type type = to_cl_device_type(config.cl_device_kind);
+   std::vector<std::unique_ptr<IAccelerator>> accelerators;
+
+   if (config.acc_workers == 1) {
+      accelerators.push_back(
+         std::make_unique<Gpu_OpenCL_Accelerator>(kernel_path, kernel_name, 0, type, config));
+      return accelerators;
+   }
+
+   size_t num_devices = Gpu_OpenCL_Accelerator::list_devices(type).size();
+   if (num_devices == 0)
+      throw std::invalid_argument("No OpenCL device of the requested type found.");
+
+   size_t num_workers = config.acc_workers > 0 ? config.acc_workers : num_devices;
+   std::cout << "[Factory] OpenCL devices found: " << num_devices
+             << ", accelerator workers: " << num_workers << "\n";
+
+   std::vector<std::shared_ptr<OpenClDeviceContext>> shared(num_devices);
+   std::vector<size_t> device_of(num_workers);
+   for (size_t w = 0; w < num_workers; ++w) {
+      device_of[w] = config.farm_mode == FarmMode::Device ? w % num_devices : 0;
+      if (!shared[device_of[w]])
+         shared[device_of[w]] = std::make_shared<OpenClDeviceContext>();
+      else
+         ++shared[device_of[w]]->workers;
+   }
+
+   for (size_t w = 0; w < num_workers; ++w)
+      accelerators.push_back(std::make_unique<Gpu_OpenCL_Accelerator>(
+         kernel_path, kernel_name, device_of[w], type, config, shared[device_of[w]]));
+   return accelerators;
+}
+
 std::unique_ptr<IDeviceRunner> create_runner_for_device(const std::string &device_type,
                                                         const std::string &kernel_path,
-                                                        const std::string &kernel_name) {
+                                                        const std::string &kernel_name,
+                                                        const RunConfig &config) {
    if (device_type == device::CPU_FF) {
-      return std::make_unique<Cpu_FF_Runner>(kernel_name);
+      return std::make_unique<Cpu_FF_Runner>(kernel_name, config.simd);
    }
 
-#ifdef __APPLE__
+   else if (device_type == device::CPU_FF_STREAM) {
+      return std::make_unique<Cpu_FF_Stream_Runner>(kernel_name, config);
+   }
 
    else if (device_type == device::GPU_CL) {
-      auto accelerator = std::make_unique<Gpu_OpenCL_Accelerator>(kernel_path, kernel_name);
-      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerator));
+      auto accelerators = create_opencl_accelerators(kernel_path, kernel_name, config);
+      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerators), config);
    }
 
+   else if (device_type == device::CPU_THREAD) {
+      // Come gpu_opencl, con --acc-workers > 1 una farm di acceleratori (0 = uno solo).
+      std::vector<std::unique_ptr<IAccelerator>> accelerators;
+      for (size_t w = 0; w < std::max<size_t>(config.acc_workers, 1); ++w)
+         accelerators.push_back(std::make_unique<Cpu_Thread_Accelerator>(kernel_name, config));
+      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerators), config);
+   }
+
+   else if (device_type == device::HYBRID) {
+      auto accelerators = create_opencl_accelerators(kernel_path, kernel_name, config);
+      return std::make_unique<HybridFarmRunner>(std::move(accelerators), kernel_name, config);
+   }
+
+#ifdef __APPLE__
+
    else if (device_type == device::GPU_MTL) {
       auto accelerator = std::make_unique<Gpu_Metal_Accelerator>(kernel_path, kernel_name);
-      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerator));
+      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerator), config);
    }
 
 #else
 
    else if (device_type == device::CPU_OMP) {
-      return std::make_unique<Cpu_OMP_Runner>(kernel_name);
+      return std::make_unique<Cpu_OMP_Runner>(kernel_name, config.simd);
    }
 
    else if (device_type == device::FPGA) {
-      auto accelerator = std::make_unique<Fpga_Accelerator>(kernel_path, kernel_name);
-      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerator));
+      auto accelerator = std::make_unique<Fpga_Accelerator>(kernel_path, kernel_name, config);
+      return std::make_unique<AcceleratorPipelineRunner>(std::move(accelerator), config);
    }
    
 #endif
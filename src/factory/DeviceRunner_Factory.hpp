@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../common/IDeviceRunner.hpp"
+#include "../common/RunConfig.hpp"
 #include <memory>
 #include <string>
 
@@ -12,9 +13,11 @@
  * @param device_type Il tipo di device (es. "cpu_omp", "gpu_opencl").
  * @param kernel_path Il percorso al file del kernel (per GPU/FPGA).
  * @param kernel_name Il nome della funzione kernel (per CPU e GPU/FPGA).
+ * @param config Opzioni facoltative di esecuzione lette dalla riga di comando.
  * @return Un puntatore all'interfaccia IDeviceRunner o nullptr se
  * il device_type non è valido.
  */
 std::unique_ptr<IDeviceRunner> create_runner_for_device(const std::string &device_type,
                                                         const std::string &kernel_path,
-                                                        const std::string &kernel_name);
\ No newline at end of file
+                                                        const std::string &kernel_name,
+                                                        const RunConfig &config);
\ No newline at end of file
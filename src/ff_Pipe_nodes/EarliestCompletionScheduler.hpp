@@ -0,0 +1,81 @@
+#pragma once
+
+#include "../../include/ff_includes.hpp"
+#include "../common/Task.hpp"
+#include "../common/WaitStrategy.hpp"
+#include "../common/WorkerLoad.hpp"
+
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Emitter della farm ibrida (worker CPU e acceleratori): assegna ogni task al worker
+ * con il completamento atteso più vicino.
+ *
+ * Il completamento atteso di un worker è (task in volo + 1) * tempo di servizio osservato
+ * (media mobile esponenziale aggiornata dal worker). Un worker di cui non si conosce ancora il
+ * tempo di servizio riceve un solo task alla volta, finché il primo completamento non lo
+ * misura. A parità di stima sceglie a rotazione.
+ *
+ * Ogni worker ha un limite di task in volo: quando tutti i worker sono al limite lo scheduler
+ * attende un completamento, così i task vengono assegnati il più tardi possibile, con stime
+ * aggiornate, invece di essere distribuiti tutti all'inizio.
+ */
+class EarliestCompletionScheduler : public ff_monode_t<Task> {
+ public:
+   /**
+    * @param loads Un WorkerLoad per ogni worker della farm, nello stesso ordine.
+    * @param max_in_flight Limite di task in volo per ogni worker, nello stesso ordine.
+    */
+   EarliestCompletionScheduler(std::vector<WorkerLoad> &loads,
+                               std::vector<size_t> max_in_flight)
+       : loads_(loads), max_in_flight_(std::move(max_in_flight)) {}
+
+   Task *svc(Task *task) override {
+      size_t best = pick_worker();
+      if (best == NONE)
+         wait_.wait([&] { return (best = pick_worker()) != NONE; });
+
+      next_ = (best + 1) % loads_.size();
+      loads_[best].in_flight.fetch_add(1, std::memory_order_relaxed);
+      ff_send_out_to(task, static_cast<int>(best));
+      return GO_ON;
+   }
+
+ private:
+   static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+   // Worker con il completamento atteso più vicino fra quelli sotto il limite, o NONE.
+   size_t pick_worker() const {
+      const size_t num_workers = loads_.size();
+
+      size_t best = NONE;
+      long long best_eta = 0;
+      for (size_t k = 0; k < num_workers; ++k) {
+         size_t w = (next_ + k) % num_workers;
+         size_t in_flight = loads_[w].in_flight.load(std::memory_order_acquire);
+         long long service_ns = loads_[w].ewma_service_ns.load(std::memory_order_relaxed);
+         if (in_flight >= max_in_flight_[w])
+            continue;
+
+         long long eta;
+         if (service_ns > 0)
+            eta = static_cast<long long>(in_flight + 1) * service_ns;
+         else if (in_flight == 0)
+            eta = 0;
+         else
+            continue; // Tempo di servizio ancora ignoto: un solo task alla volta
+
+         if (best == NONE || eta < best_eta) {
+            best = w;
+            best_eta = eta;
+         }
+      }
+      return best;
+   }
+
+   std::vector<WorkerLoad> &loads_;
+   std::vector<size_t> max_in_flight_;
+   size_t next_{0};     // Primo worker da considerare alla prossima scelta
+   SpinYieldWait wait_; // Attesa di un completamento quando tutti i worker sono al limite
+};
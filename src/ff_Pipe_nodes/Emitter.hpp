@@ -1,22 +1,40 @@
 #pragma once
 
 #include "../../include/ff_includes.hpp"
+#include "../common/AlignedAllocator.hpp"
 #include "../common/Task.hpp"
+#include "../common/TaskPool.hpp"
+
+#include <memory>
 
 /**
  * @brief Nodo sorgente della pipeline FastFlow.
  *
  * Il nodo Emitter genera i Task da far processare al nodo ff_node_acc_t.
- * Inizializza i dati di input una sola volta, poi crea dinamicamente un nuovo
- * oggetto Task per ogni richiesta dalla pipeline.
+ * Con un pool di task (pool_slots > 0) ogni task è uno slot del TaskPool, con i propri vettori
+ * di input/output, restituito al pool da chi lo completa. Altrimenti inizializza i dati di
+ * input una sola volta, condivisi da tutti i task, e crea dinamicamente un nuovo oggetto Task
+ * per ogni richiesta dalla pipeline.
  */
 class Emitter : public ff_node {
  public:
    /**
     * @param n Dimensione dei vettori da processare.
     * @param num_tasks Il numero totale di task da generare.
+    * @param size_levels Numero di dimensioni diverse dei task: il task i-esimo processa i
+    * primi n >> (i % size_levels) elementi (vedi RunConfig::mixed_n). Con 1 hanno tutti n.
+    * @param pool_slots Slot del pool di task (vedi TaskPool::slots_for), 0 = vettori condivisi
+    * e un nuovo Task per ogni richiesta.
     */
-   explicit Emitter(size_t n, size_t num_tasks) : tasks_to_send(num_tasks), tasks_sent(0) {
+   explicit Emitter(size_t n, size_t num_tasks, size_t size_levels = 1, size_t pool_slots = 0)
+       : tasks_to_send(num_tasks), tasks_sent(0), size_levels_(size_levels ? size_levels : 1) {
+      n_ = n;
+      if (pool_slots > 0) {
+         pool_ = std::make_unique<TaskPool>(pool_slots, n);
+         a_ptr_ = b_ptr_ = c_ptr_ = nullptr;
+         return;
+      }
+
       // Init dei vettori con i dati di input.
       a.resize(n);
       b.resize(n);
@@ -31,17 +49,23 @@ class Emitter : public ff_node {
       a_ptr_ = a.data();
       b_ptr_ = b.data();
       c_ptr_ = c.data();
-      n_ = n;
    }
 
    /**
     * @brief Genera un nuovo Task fino al raggiungimento del numero totale.
-    * @return Un puntatore a un nuovo Task, o FF_EOS al termine.
+    * @return Un puntatore a un nuovo Task (o a uno slot libero del pool), o FF_EOS al termine.
     */
    void *svc(void *) override {
       if (tasks_sent < tasks_to_send) {
+         size_t task_n = n_ >> (tasks_sent % size_levels_);
          tasks_sent++;
-         return new Task{a_ptr_, b_ptr_, c_ptr_, n_, tasks_sent};
+         if (pool_) {
+            Task *task = pool_->acquire();
+            task->n = task_n ? task_n : 1;
+            task->id = tasks_sent;
+            return task;
+         }
+         return new Task{a_ptr_, b_ptr_, c_ptr_, task_n ? task_n : 1, tasks_sent};
       }
 
       return FF_EOS; // Tutti i task inviati -> fine stream
@@ -50,7 +74,9 @@ class Emitter : public ff_node {
  private:
    size_t tasks_to_send;          // Numero totale di task da inviare
    size_t tasks_sent;             // Numero di task già inviati
-   std::vector<int> a, b, c;      // Vettori di input/output
+   HostVector<int> a, b, c;       // Vettori di input/output (allineati alla pagina)
    int *a_ptr_, *b_ptr_, *c_ptr_; // Puntatori ai dati di input/output
    size_t n_;                     // Dimensione dei vettori
+   size_t size_levels_;           // Numero di dimensioni diverse dei task
+   std::unique_ptr<TaskPool> pool_; // Pool di task (nullptr = vettori condivisi)
 };
\ No newline at end of file
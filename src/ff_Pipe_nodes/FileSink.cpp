@@ -0,0 +1,59 @@
+#include "FileSink.hpp"
+#include "../common/TaskPool.hpp"
+#include "../common/Tracer.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+
+FileSink::FileSink(const std::string &path, size_t n) : path_(path), n_(n) {
+   fd_ = open(path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   if (fd_ < 0)
+      throw std::invalid_argument("Cannot create sink file '" + path_ +
+                                  "': " + std::strerror(errno) + ".");
+}
+
+FileSink::~FileSink() {
+   if (fd_ >= 0)
+      close(fd_);
+}
+
+/**
+ * @brief Scrive l'output del task nel suo record e lo rilascia.
+ */
+void *FileSink::svc(void *t) {
+   auto *task = static_cast<Task *>(t);
+   auto t0 = std::chrono::steady_clock::now();
+
+   const char *data = reinterpret_cast<const char *>(task->c);
+   size_t bytes = task->n * sizeof(int);
+   size_t offset = (task->id - 1) * n_ * sizeof(int);
+   while (bytes > 0) {
+      ssize_t w = pwrite(fd_, data, bytes, off_t(offset));
+      if (w < 0 && errno == EINTR)
+         continue;
+      if (w < 0) {
+         std::cerr << "[ERROR] FileSink: write of '" << path_ << "' failed: "
+                   << std::strerror(errno) << ".\n";
+         exit(EXIT_FAILURE);
+      }
+      data += w;
+      offset += size_t(w);
+      bytes -= size_t(w);
+   }
+   Tracer::complete("Write", task->id, t0, std::chrono::steady_clock::now());
+
+   ++tasks_written_;
+   bytes_written_ += task->n * sizeof(int);
+   release_task(task);
+   return FF_GO_ON;
+}
+
+void FileSink::svc_end() {
+   std::cerr << "[FileSink] " << tasks_written_ << " tasks (" << bytes_written_ / 1.0e6
+             << " MB) written to " << path_ << ".\n";
+}
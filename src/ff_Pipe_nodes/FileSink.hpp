@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../../include/ff_includes.hpp"
+#include "../common/Task.hpp"
+
+#include <string>
+
+/**
+ * @brief Nodo finale della pipeline FastFlow che scrive l'output dei task in un file binario.
+ *
+ * Il nodo segue ff_node_acc_t (con forward_output) e gira su un proprio thread, quindi la
+ * scrittura dei risultati si sovrappone al calcolo dei task successivi. L'output del task con
+ * id i viene scritto con pwrite nel record i-1 del file (n interi per record), quindi il file
+ * ha lo stesso ordine dei task anche se i task arrivano in un ordine diverso. Scritto il
+ * risultato, il task viene rilasciato (vedi release_task).
+ */
+class FileSink : public ff_node {
+ public:
+   /**
+    * @param path File di output, creato o troncato.
+    * @param n Elementi di un record (dimensione massima dei task).
+    */
+   FileSink(const std::string &path, size_t n);
+   ~FileSink() override;
+
+ protected:
+   void *svc(void *t) override;
+   void svc_end() override;
+
+ private:
+   std::string path_;
+   size_t n_;
+   int fd_{-1};
+   size_t tasks_written_{0};
+   size_t bytes_written_{0};
+};
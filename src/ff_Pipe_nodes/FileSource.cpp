@@ -0,0 +1,190 @@
+#include "FileSource.hpp"
+#include "../common/Tracer.hpp"
+#include "Emitter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FileSource::FileSource(const RunConfig &config, size_t n, size_t num_tasks, size_t pool_slots)
+    : path_(config.source_path), mode_(config.source_mode), n_(std::max<size_t>(n, 1)),
+      num_tasks_(num_tasks), size_levels_(config.mixed_n ? config.mixed_n : 1),
+      read_ahead_(std::max<size_t>(config.read_ahead, 1)) {
+   // Con zero_copy e pinned i buffer del device vengono legati una volta per slot del pool
+   // (vedi BufferManager): gli input devono stare nello slot, non in un record diverso a ogni
+   // task.
+   if (mode_ == SourceMode::Mmap && config.mem_mode != MemMode::Copy) {
+      std::cerr << "[FileSource] --mem=" << (config.mem_mode == MemMode::Pinned ? "pinned"
+                                                                                : "zero_copy")
+                << " binds the device buffers to the task slots, using "
+                   "--source-mode=prefetch.\n";
+      mode_ = SourceMode::Prefetch;
+   }
+
+   fd_ = open(path_.c_str(), O_RDONLY);
+   if (fd_ < 0)
+      throw std::invalid_argument("Cannot open source file '" + path_ +
+                                  "': " + std::strerror(errno) + ".");
+
+   struct stat st {};
+   fstat(fd_, &st);
+   const size_t record_bytes = 2 * n_ * sizeof(int);
+   records_ = size_t(st.st_size) / record_bytes;
+   if (records_ == 0) {
+      close(fd_);
+      throw std::invalid_argument("Source file '" + path_ + "' is smaller than one task (" +
+                                  std::to_string(record_bytes) +
+                                  " bytes: a and b of N ints).");
+   }
+
+   if (mode_ == SourceMode::Mmap) {
+      // Mappatura privata e scrivibile: nessuno scrive sugli input, ma un'eventuale scrittura
+      // (ad esempio di una mappatura OpenCL) resta in copy-on-write e non tocca il file.
+      map_bytes_ = records_ * record_bytes;
+      void *map = mmap(nullptr, map_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd_, 0);
+      if (map == MAP_FAILED) {
+         close(fd_);
+         throw std::invalid_argument("Cannot map source file '" + path_ +
+                                     "': " + std::strerror(errno) + ".");
+      }
+      map_ = static_cast<char *>(map);
+      madvise(map_, map_bytes_, MADV_SEQUENTIAL);
+   } else
+      ready_ = std::make_unique<BlockingQueue<Task *>>(read_ahead_);
+
+   // Con mmap gli input puntano alla mappatura: gli slot contengono solo l'output.
+   pool_ = std::make_unique<TaskPool>(pool_slots, n_, mode_ == SourceMode::Prefetch);
+
+   std::cerr << "[FileSource] " << path_ << ": " << records_ << " tasks of " << n_
+             << " elements, " << (mode_ == SourceMode::Mmap ? "mmap" : "prefetch")
+             << " (read-ahead " << read_ahead_ << ", " << pool_slots << " task slots).\n";
+}
+
+FileSource::~FileSource() {
+   if (map_)
+      munmap(map_, map_bytes_);
+   if (fd_ >= 0)
+      close(fd_);
+}
+
+size_t FileSource::task_n(size_t i) const {
+   size_t n = n_ >> (i % size_levels_);
+   return n ? n : 1;
+}
+
+size_t FileSource::record_offset(size_t i) const {
+   return (i % records_) * 2 * n_ * sizeof(int);
+}
+
+/**
+ * @brief MADV_WILLNEED sul record del task i, allineato alla pagina: il kernel avvia la
+ * lettura in background e ritorna subito.
+ */
+void FileSource::advise(size_t i) const {
+   const size_t page = size_t(sysconf(_SC_PAGESIZE));
+   size_t begin = record_offset(i) / page * page;
+   size_t end = record_offset(i) + 2 * n_ * sizeof(int);
+   madvise(map_ + begin, end - begin, MADV_WILLNEED);
+}
+
+int FileSource::svc_init() {
+   Tracer::set_thread_name("File Source");
+   if (mode_ == SourceMode::Mmap) {
+      for (size_t i = 0; i < std::min(read_ahead_, num_tasks_); ++i)
+         advise(i);
+   } else
+      reader_ = std::thread(&FileSource::readerLoop, this);
+   return 0;
+}
+
+/**
+ * @brief Invia il task successivo: con Mmap punta gli input al suo record, con Prefetch prende
+ * il task già letto dal thread di I/O.
+ * @return Il task, o FF_EOS al termine.
+ */
+void *FileSource::svc(void *) {
+   if (mode_ == SourceMode::Prefetch) {
+      Task *task = ready_->pop();
+      return task ? task : FF_EOS;
+   }
+
+   if (tasks_sent_ == num_tasks_)
+      return FF_EOS;
+
+   size_t i = tasks_sent_++;
+   if (i + read_ahead_ < num_tasks_)
+      advise(i + read_ahead_);
+
+   Task *task = pool_->acquire();
+   task->a = reinterpret_cast<int *>(map_ + record_offset(i));
+   task->b = task->a + n_;
+   task->n = task_n(i);
+   task->id = i + 1;
+   return task;
+}
+
+void FileSource::svc_end() {
+   if (reader_.joinable())
+      reader_.join();
+}
+
+/**
+ * @brief Legge con pread i record dei task nei vettori degli slot del pool. L'attesa di uno
+ * slot libero (pool) e di un posto nella coda (read_ahead) limitano la lettura in anticipo.
+ */
+void FileSource::readerLoop() {
+   Tracer::set_thread_name("File Reader");
+
+   // Legge esattamente bytes byte dall'offset, ripetendo le letture parziali.
+   auto read_fully = [this](int *dst, size_t bytes, size_t offset) {
+      char *out = reinterpret_cast<char *>(dst);
+      while (bytes > 0) {
+         ssize_t r = pread(fd_, out, bytes, off_t(offset));
+         if (r < 0 && errno == EINTR)
+            continue;
+         if (r <= 0) {
+            std::cerr << "[ERROR] FileSource: read of '" << path_ << "' failed: "
+                      << (r < 0 ? std::strerror(errno) : "unexpected end of file") << ".\n";
+            exit(EXIT_FAILURE);
+         }
+         out += r;
+         offset += size_t(r);
+         bytes -= size_t(r);
+      }
+   };
+
+   for (size_t i = 0; i < num_tasks_; ++i) {
+      Task *task = pool_->acquire();
+      size_t n = task_n(i);
+
+      auto t0 = std::chrono::steady_clock::now();
+      read_fully(task->a, n * sizeof(int), record_offset(i));
+      read_fully(task->b, n * sizeof(int), record_offset(i) + n_ * sizeof(int));
+      Tracer::complete("Read", i + 1, t0, std::chrono::steady_clock::now());
+
+      task->n = n;
+      task->id = i + 1;
+      ready_->push(task);
+   }
+   ready_->push(nullptr);
+}
+
+std::unique_ptr<ff_node> make_source_node(const RunConfig &config, size_t n, size_t num_tasks,
+                                          size_t batch_tasks) {
+   if (config.source_path.empty()) {
+      size_t slots =
+         config.task_pool ? TaskPool::slots_for(config, n, num_tasks, batch_tasks) : 0;
+      return std::make_unique<Emitter>(n, num_tasks, config.mixed_n, slots);
+   }
+
+   // Il file ha bisogno del pool anche con --task-pool=off: ogni task ha il proprio output.
+   return std::make_unique<FileSource>(config, n, num_tasks,
+                                       TaskPool::slots_for(config, n, num_tasks, batch_tasks));
+}
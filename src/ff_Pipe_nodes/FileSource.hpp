@@ -0,0 +1,80 @@
+#pragma once
+
+#include "../../include/ff_includes.hpp"
+#include "../common/BlockingQueue.hpp"
+#include "../common/RunConfig.hpp"
+#include "../common/Task.hpp"
+#include "../common/TaskPool.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Nodo sorgente della pipeline FastFlow che legge gli input dei task da un file
+ * binario, al posto dei dati generati dall'Emitter.
+ *
+ * Il file è una sequenza di record, uno per task, ognuno con n interi del vettore a seguiti da
+ * n interi del vettore b. Se i task sono più dei record il file viene riletto dall'inizio. Con
+ * mixed_n il task usa i primi elementi del suo record, come con l'Emitter.
+ *
+ * I task sono slot di un TaskPool, restituiti da chi li completa. Due modalità di lettura:
+ * - Mmap: il file è mappato in memoria e gli input del task puntano al suo record, senza
+ *   copie. Il nodo chiede al kernel (madvise) di leggere in anticipo i read_ahead record
+ *   successivi, così i page fault dell'upload trovano i dati già in memoria.
+ * - Prefetch: un thread di I/O legge con pread i record nei vettori dei task del pool e li
+ *   accoda al nodo, al più read_ahead task in anticipo: la lettura del task i+1 si sovrappone
+ *   al calcolo del task i.
+ */
+class FileSource : public ff_node {
+ public:
+   /**
+    * @param config Opzioni di esecuzione (file, modalità di lettura, read-ahead, mixed_n).
+    * @param n Elementi di ogni vettore (dimensione di un record).
+    * @param num_tasks Il numero totale di task da generare.
+    * @param pool_slots Slot del pool di task (vedi TaskPool::slots_for).
+    */
+   FileSource(const RunConfig &config, size_t n, size_t num_tasks, size_t pool_slots);
+   ~FileSource() override;
+
+ protected:
+   int svc_init() override;
+   void *svc(void *) override;
+   void svc_end() override;
+
+ private:
+   // Loop del thread di I/O (Prefetch): legge i task e li accoda a ready_, nullptr alla fine.
+   void readerLoop();
+
+   // Chiede al kernel di leggere in anticipo il record del task i (Mmap).
+   void advise(size_t i) const;
+
+   // Dimensione del task i (vedi RunConfig::mixed_n) e offset in byte del suo record.
+   size_t task_n(size_t i) const;
+   size_t record_offset(size_t i) const;
+
+   std::string path_;
+   SourceMode mode_;
+   size_t n_;
+   size_t num_tasks_;
+   size_t size_levels_;
+   size_t read_ahead_;
+   size_t records_{0};   // Record completi nel file
+   size_t tasks_sent_{0};
+
+   int fd_{-1};
+   char *map_{nullptr}; // Mappatura del file (Mmap)
+   size_t map_bytes_{0};
+
+   std::unique_ptr<TaskPool> pool_;
+   std::unique_ptr<BlockingQueue<Task *>> ready_; // Task letti in anticipo (Prefetch)
+   std::thread reader_;
+};
+
+/**
+ * @brief Crea il nodo sorgente della pipeline: FileSource con RunConfig::source_path,
+ * altrimenti l'Emitter (con il pool di task se RunConfig::task_pool).
+ * @param batch_tasks Task per batch del TaskBatcher, per dimensionare il pool di task.
+ */
+std::unique_ptr<ff_node> make_source_node(const RunConfig &config, size_t n, size_t num_tasks,
+                                          size_t batch_tasks = 1);
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../../include/ff_includes.hpp"
+#include "../common/Task.hpp"
+#include "../common/WorkerLoad.hpp"
+
+#include <vector>
+
+/**
+ * @brief Emitter della farm di acceleratori: assegna ogni task al worker con meno task in
+ * volo (assegnati e non ancora completati).
+ *
+ * A parità di carico sceglie a rotazione, così con worker identici e carico uniforme la
+ * distribuzione degenera in un round-robin.
+ */
+class InFlightScheduler : public ff_monode_t<Task> {
+ public:
+   /**
+    * @param loads Un WorkerLoad per ogni worker della farm, nello stesso ordine.
+    */
+   explicit InFlightScheduler(std::vector<WorkerLoad> &loads) : loads_(loads) {}
+
+   Task *svc(Task *task) override {
+      const size_t num_workers = loads_.size();
+      size_t best = next_;
+      size_t best_load = loads_[best].in_flight.load(std::memory_order_relaxed);
+
+      for (size_t k = 1; k < num_workers && best_load > 0; ++k) {
+         size_t w = (next_ + k) % num_workers;
+         size_t load = loads_[w].in_flight.load(std::memory_order_relaxed);
+         if (load < best_load) {
+            best = w;
+            best_load = load;
+         }
+      }
+
+      next_ = (best + 1) % num_workers;
+      loads_[best].in_flight.fetch_add(1, std::memory_order_relaxed);
+      ff_send_out_to(task, static_cast<int>(best));
+      return GO_ON;
+   }
+
+ private:
+   std::vector<WorkerLoad> &loads_;
+   size_t next_{0}; // Primo worker da considerare alla prossima scelta
+};
@@ -0,0 +1,171 @@
+#include "TaskBatcher.hpp"
+#include "../common/Tracer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// Con batch_size automatico ogni batch contiene circa AUTO_TARGET_ELEMS elementi
+// (4 MB per vettore), fino a un massimo di AUTO_MAX_TASKS task.
+static constexpr size_t AUTO_TARGET_ELEMS = size_t(1) << 20;
+static constexpr size_t AUTO_MAX_TASKS = 256;
+
+TaskBatcher::TaskBatcher(size_t batch_size, bool adaptive, size_t timeout_us,
+                         size_t batch_slots)
+    : batch_size_(std::max<size_t>(batch_size, 1)), adaptive_(adaptive), timeout_(timeout_us),
+      batches_(std::max<size_t>(batch_slots, 1), TaskPool::BatchSlots{}) {}
+
+size_t TaskBatcher::auto_batch_size(size_t n) {
+   n = std::max<size_t>(n, 1);
+   return std::clamp<size_t>((AUTO_TARGET_ELEMS + n - 1) / n, 1, AUTO_MAX_TASKS);
+}
+
+size_t TaskBatcher::tasks_per_batch(size_t n) const {
+   return adaptive_ ? auto_batch_size(n) : batch_size_;
+}
+
+size_t TaskBatcher::batch_slots_for(size_t task_slots, size_t batch_tasks) {
+   return task_slots / std::max<size_t>(batch_tasks, 1) + 1;
+}
+
+int TaskBatcher::svc_init() {
+   flusher_ = std::thread(&TaskBatcher::flushLoop, this);
+   return 0;
+}
+
+/**
+ * @brief Accoda il task al batch in costruzione e sveglia il thread Flush, che lo invia
+ * quando è pieno o scaduto.
+ */
+void *TaskBatcher::svc(void *t) {
+   auto *task = static_cast<Task *>(t);
+
+   // L'ora di arrivo dei task viene impostata qui, così il tempo nel nodo include l'attesa
+   // nel batch.
+   task->arrival_time = std::chrono::steady_clock::now();
+
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(task);
+   }
+   pending_cv_.notify_one();
+   return FF_GO_ON;
+}
+
+/**
+ * @brief Loop del thread Flush. Senza task attende il primo; con un batch incompleto attende
+ * altri task fino alla scadenza del primo, poi invia quello che c'è.
+ */
+void TaskBatcher::flushLoop() {
+   Tracer::set_thread_name("Batch Flush");
+   std::unique_lock<std::mutex> lock(mutex_);
+   while (true) {
+      if (pending_.empty()) {
+         if (stopping_)
+            break;
+         pending_cv_.wait(lock);
+         continue;
+      }
+
+      size_t batch_size = tasks_per_batch(pending_.front()->n);
+      auto deadline = pending_.front()->arrival_time + timeout_;
+      if (pending_.size() < batch_size && !stopping_ &&
+          std::chrono::steady_clock::now() < deadline) {
+         pending_cv_.wait_until(lock, deadline);
+         continue;
+      }
+
+      size_t count = std::min(pending_.size(), batch_size);
+      std::vector<Task *> members(pending_.begin(), pending_.begin() + count);
+      pending_.erase(pending_.begin(), pending_.begin() + count);
+
+      lock.unlock();
+      flush(std::move(members), batch_size);
+      lock.lock();
+   }
+}
+
+/**
+ * @brief Fine dello stream: il thread Flush invia i task in attesa prima che l'EOS prosegua.
+ */
+void TaskBatcher::eosnotify(ssize_t) {
+   stop_flusher();
+   std::cerr << "[TaskBatcher] Sent " << batches_sent_ << " batches of up to "
+             << largest_batch_ << " tasks.\n";
+}
+
+void TaskBatcher::svc_end() { stop_flusher(); }
+
+void TaskBatcher::stop_flusher() {
+   {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+   }
+   pending_cv_.notify_one();
+   if (flusher_.joinable())
+      flusher_.join();
+}
+
+void TaskBatcher::flush(std::vector<Task *> members, size_t batch_size) {
+   batches_sent_++;
+   largest_batch_ = std::max(largest_batch_, members.size());
+   if (members.size() == 1) {
+      ff_send_out(members.front());
+      return;
+   }
+
+   // Dimensione piena del batch: tutti i batch hanno la stessa dimensione se i task hanno lo
+   // stesso N, anche quelli incompleti.
+   size_t member_n = members.front()->n;
+   size_t total_n = 0;
+   for (Task *member : members)
+      total_n += member->n;
+   total_n = std::max(total_n, batch_size * member_n);
+
+   // Contenitore riciclato: i vettori crescono solo per un batch più grande dei precedenti,
+   // e solo la coda oltre i membri viene azzerata.
+   Task *task = batches_.acquire();
+   TaskBatch &batch = *task->batch;
+   if (batch.a.size() < total_n) {
+      batch.a.resize(total_n);
+      batch.b.resize(total_n);
+      batch.c.resize(total_n);
+   }
+
+   size_t offset = 0;
+   batch.offsets.clear();
+   for (Task *member : members) {
+      std::memcpy(batch.a.data() + offset, member->a, member->n * sizeof(int));
+      std::memcpy(batch.b.data() + offset, member->b, member->n * sizeof(int));
+      batch.offsets.push_back(offset);
+      offset += member->n;
+   }
+   std::fill(batch.a.begin() + offset, batch.a.begin() + total_n, 0);
+   std::fill(batch.b.begin() + offset, batch.b.begin() + total_n, 0);
+   batch.members = std::move(members);
+
+   task->a = batch.a.data();
+   task->b = batch.b.data();
+   task->c = batch.c.data();
+   task->n = total_n;
+   task->id = batch.members.front()->id;
+   task->arrival_time = batch.members.front()->arrival_time;
+   ff_send_out(task);
+}
+
+void TaskBatcher::scatter_results(Task &batch) {
+   const TaskBatch &data = *batch.batch;
+   for (size_t i = 0; i < data.members.size(); ++i)
+      std::memcpy(data.members[i]->c, data.c.data() + data.offsets[i],
+                  data.members[i]->n * sizeof(int));
+}
+
+void TaskBatcher::record_members(Task &batch, StatsCollector &stats,
+                                 std::chrono::steady_clock::time_point end,
+                                 long long batch_computed_ns) {
+   const TaskBatch &data = *batch.batch;
+   long long member_computed_ns = batch_computed_ns / (long long)data.members.size();
+
+   for (Task *member : data.members)
+      stats.record_task(member->arrival_time, end, member_computed_ns);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../../include/ff_includes.hpp"
+#include "../common/StatsCollector.hpp"
+#include "../common/Task.hpp"
+#include "../common/TaskPool.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Nodo FastFlow che raggruppa più task piccoli in un unico task (batch) prima di
+ * ff_node_acc_t, così i costi fissi per task (accodamenti, eventi, lettura bloccante) vengono
+ * pagati una volta per batch.
+ *
+ * I vettori di input dei task vengono copiati in vettori contigui (TaskBatch) e il batch viene
+ * inviato come un task normale di dimensione batch_size * n: il kernel viene lanciato una sola
+ * volta. Al termine del download il Consumer copia i risultati nel vettore di output di ogni
+ * task (scatter_results) e ne registra le statistiche (record_members).
+ *
+ * I task dei batch sono contenitori riciclati (TaskPool::BatchSlots), restituiti da
+ * ff_node_acc_t dopo aver scomposto il batch: a regime il nodo non alloca nulla. Se sono tutti
+ * in volo il thread Flush attende, limitando i batch in memoria.
+ *
+ * Il batch viene inviato quando è pieno, quando il suo primo task aspetta da timeout_us o alla
+ * fine dello stream. svc() accoda solo i task: i batch vengono formati e inviati da un thread
+ * interno (Flush), che attende il riempimento del batch al più fino alla scadenza del primo
+ * task, anche se dalla sorgente non arriva più nulla. Il thread Flush è l'unico a chiamare
+ * ff_send_out (svc() non invia mai) e eosnotify() lo attende prima che FF propaghi l'EOS, come
+ * il Consumer di ff_node_acc_t. I batch incompleti vengono riempiti di zeri fino alla
+ * dimensione piena, per non far riallocare i buffer del device.
+ */
+class TaskBatcher : public ff_node {
+ public:
+   /**
+    * @param batch_size Task per batch, ignorato se adaptive è true.
+    * @param adaptive Se true sceglie i task per batch in base alla dimensione del primo task.
+    * @param timeout_us Attesa massima del primo task di un batch, in microsecondi.
+    * @param batch_slots Contenitori di batch riciclati (vedi batch_slots_for).
+    */
+   TaskBatcher(size_t batch_size, bool adaptive, size_t timeout_us, size_t batch_slots);
+
+   int svc_init() override;
+   void *svc(void *t) override;
+   void eosnotify(ssize_t id = -1) override;
+   void svc_end() override;
+
+   // Task per batch scelti in modalità adattiva per task di n elementi.
+   static size_t auto_batch_size(size_t n);
+
+   // Task per batch con task di n elementi.
+   size_t tasks_per_batch(size_t n) const;
+
+   // Contenitori di batch: quanti batch pieni stanno nel pool di task della sorgente, più uno.
+   static size_t batch_slots_for(size_t task_slots, size_t batch_tasks);
+
+   // Copia i risultati del batch nei vettori di output dei task che contiene.
+   static void scatter_results(Task &batch);
+
+   // Registra le statistiche di ogni task del batch (rilasciati poi da ff_node_acc_t).
+   static void record_members(Task &batch, StatsCollector &stats,
+                              std::chrono::steady_clock::time_point end,
+                              long long batch_computed_ns);
+
+ private:
+   // Loop del thread Flush: invia i batch pieni, scaduti o, alla fine, quello incompleto.
+   void flushLoop();
+
+   // Invia un batch con i task dati (un task da solo viene inviato così com'è).
+   void flush(std::vector<Task *> members, size_t batch_size);
+
+   // Ferma il thread Flush dopo l'invio dei task in attesa e ne attende la terminazione.
+   void stop_flusher();
+
+   size_t batch_size_;
+   bool adaptive_;
+   std::chrono::microseconds timeout_;
+   size_t batches_sent_{0};
+   size_t largest_batch_{0};
+   TaskPool batches_; // Contenitori dei batch, restituiti da ff_node_acc_t
+
+   // Task in attesa di formare un batch, accodati da svc() e presi dal thread Flush.
+   std::mutex mutex_;
+   std::condition_variable pending_cv_;
+   std::deque<Task *> pending_;
+   bool stopping_{false}; // Fine dello stream: il thread Flush invia tutto e termina
+   std::thread flusher_;
+};
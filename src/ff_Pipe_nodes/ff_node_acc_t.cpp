@@ -1,4 +1,10 @@
 #include "ff_node_acc_t.hpp"
+#include "../common/QueueFactory.hpp"
+#include "../common/TaskPool.hpp"
+#include "../common/Tracer.hpp"
+#include "TaskBatcher.hpp"
+
+#include <algorithm>
 
 /**
  * @brief Implementazione del nodo FastFlow che orchestra l'offloading.
@@ -7,86 +13,282 @@
  * 1. Producer (Upload+Launch): Trasferisce i dati dall'host al device e
  *    avvia l'esecuzione del kernel.
  * 2. Consumer (Download): Trasferisce i risultati dal device all'host.
+ *
+ * Con acc_stages = 3 lo stadio Producer viene diviso in due thread (Upload e Launch), così
+ * l'upload del task n+1 non attende l'accodamento del kernel del task n.
+ *
+ * Con completion = Callback il download non occupa il Consumer: viene accodato dal Launch e i
+ * task completati arrivano nella readyQ_ dalle callback del runtime.
  */
 
+using Clock = std::chrono::steady_clock;
+
+// Helper per la durata in ns tra due istanti.
+static long long elapsed_ns(Clock::time_point from, Clock::time_point to) {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
 // Sentinella usata per segnalare la fine dello stream di dati alla pipeline interna.
 static char sentinel_obj;
 void *const ff_node_acc_t::SENTINEL = &sentinel_obj;
 
+/**
+ * @brief Crea la coda dei task pronti. Con il download asincrono vi scrivono le callback del
+ * runtime OpenCL, da thread diversi, quindi una SpscQueue diventa una MpmcQueue. I task in
+ * volo sono già limitati dal pool di buffer, quindi la coda non ha il limite di
+ * pipeline_depth: una callback non deve mai bloccarsi su una coda piena. La MpmcQueue ha
+ * quindi posto almeno per tutti i set del pool (e la sentinella), anche con una
+ * --queue-capacity più piccola.
+ */
+static std::unique_ptr<IQueue<void *>> make_ready_queue(const RunConfig &config) {
+   if (config.completion != CompletionMode::Callback)
+      return make_queue<void *>(config);
+
+   if (config.queue_kind == QueueKind::Blocking)
+      return make_queue<void *>(QueueKind::Blocking, config.wait_kind, 0);
+   size_t in_flight = std::max(config.pool_size, RunConfig::MAX_POOL_SETS) + 1;
+   return make_queue<void *>(QueueKind::Mpmc, config.wait_kind,
+                             std::max(config.queue_capacity, in_flight));
+}
+
 /**
  * @brief Costruttore del nodo.
  *
  * @param acc Puntatore a un'implementazione di IAccelerator.
  * @param stats Puntatore all'oggetto per le statistiche finali.
+ * @param config Opzioni di esecuzione (code interne, numero di stadi, profondità).
+ * @param load Carico del worker, aggiornato al completamento di ogni task (solo in una farm).
  */
-ff_node_acc_t::ff_node_acc_t(IAccelerator *acc, StatsCollector *stats)
-    : accelerator_(acc), stats_(stats) {}
+ff_node_acc_t::ff_node_acc_t(IAccelerator *acc, StatsCollector *stats, const RunConfig &config,
+                             WorkerLoad *load)
+    : accelerator_(acc), stats_(stats), load_(load), three_stages_(config.acc_stages == 3),
+      async_download_(config.completion == CompletionMode::Callback),
+      warmup_tasks_(config.warmup_tasks), warmup_n_(config.expected_n),
+      inQ_(make_queue<void *>(config)), launchQ_(make_queue<void *>(config)),
+      readyQ_(make_ready_queue(config)) {}
 
 ff_node_acc_t::~ff_node_acc_t() = default;
 
 /**
- * @brief Metodo di inizializzazione del nodo
+ * @brief Inizializza l'acceleratore ed esegue i task di warm-up. Le durate vengono riportate a
+ * parte come tempo di avvio, i task di warm-up non entrano nelle statistiche.
  */
-int ff_node_acc_t::svc_init() {
+bool ff_node_acc_t::prepare() {
+   if (prepared_)
+      return true;
    std::cerr << "[Accelerator Node] Initializing...\n";
 
    // Trova il tipo di acceleratore, crea il contesto e la coda di comandi
    // OpenCL, legge il sorgente del kernel, lo compila e prepara l'oggetto
    // kernel, inizializza il pool di buffer e la coda degli indici liberi.
+   auto init_start = Clock::now();
    if (!accelerator_ || !accelerator_->initialize()) {
       std::cerr << "[ERROR] Accelerator setup failed.\n";
-      return -1;
+      return false;
    }
+   auto init_end = Clock::now();
+   Tracer::complete("Initialize", 0, init_start, init_end);
+
+   // Task di warm-up su vettori propri, uno alla volta: i primi lanci pagano allocazioni
+   // pigre del driver, page fault e cache fredde.
+   size_t warmup_n = warmup_tasks_ > 0 ? std::max<size_t>(warmup_n_, 1) : 0;
+   HostVector<int> a(warmup_n, 1), b(warmup_n, 2), c(warmup_n);
+   for (size_t i = 0; i < warmup_tasks_; ++i) {
+      Task task{};
+      task.a = a.data();
+      task.b = b.data();
+      task.c = c.data();
+      task.n = warmup_n;
+      run_warmup_task(&task);
+   }
+   auto warmup_end = Clock::now();
+   if (warmup_tasks_ > 0)
+      std::cerr << "[Accelerator Node] " << warmup_tasks_ << " warm-up tasks in "
+                << elapsed_ns(init_end, warmup_end) / 1.0e6 << " ms.\n";
+
+   stats_->record_startup(elapsed_ns(init_start, init_end), elapsed_ns(init_end, warmup_end));
+   prepared_ = true;
+   return true;
+}
+
+bool ff_node_acc_t::prepare_all(const std::vector<ff_node_acc_t *> &nodes) {
+   std::vector<char> ok(nodes.size(), 0);
+   std::vector<std::thread> threads;
+   for (size_t i = 0; i < nodes.size(); ++i)
+      threads.emplace_back([&, i] {
+         Tracer::set_thread_name("Accelerator Init");
+         ok[i] = nodes[i]->prepare();
+      });
+   for (auto &thread : threads)
+      thread.join();
+   return std::all_of(ok.begin(), ok.end(), [](char v) { return v != 0; });
+}
+
+/**
+ * @brief Upload, kernel e download di un task di warm-up, senza misure né statistiche.
+ */
+void ff_node_acc_t::run_warmup_task(Task *task) {
+   auto t0 = Clock::now();
+   task->buffer_idx = accelerator_->acquire_buffer_set(sizeof(int) * task->n);
+   accelerator_->send_data_to_device(task);
+   accelerator_->execute_kernel(task);
+   long long computed_ns = 0;
+   accelerator_->get_results_from_device(task, computed_ns);
+   accelerator_->release_buffer_set(task->buffer_idx);
+   Tracer::complete("Warm-up", task->id, t0, Clock::now());
+}
 
-   // Avvia i due thread.
-   producerTh_ = std::thread(&ff_node_acc_t::producerLoop, this);
+/**
+ * @brief Metodo di inizializzazione del nodo
+ */
+int ff_node_acc_t::svc_init() {
+   Tracer::set_thread_name("Accelerator Node");
+   if (!prepare())
+      return -1;
+
+   // Avvia i thread della pipeline interna.
+   if (three_stages_) {
+      producerTh_ = std::thread(&ff_node_acc_t::uploadLoop, this);
+      launcherTh_ = std::thread(&ff_node_acc_t::launchLoop, this);
+   } else
+      producerTh_ = std::thread(&ff_node_acc_t::producerLoop, this);
    consumerTh_ = std::thread(&ff_node_acc_t::consumerLoop, this);
 
-   std::cerr << "[Accelerator Node] Internal 2-stage pipeline started.\n\n";
+   std::cerr << "[Accelerator Node] Internal " << (three_stages_ ? 3 : 2)
+             << "-stage pipeline started" << (async_download_ ? " (async download)" : "")
+             << ".\n\n";
    return 0;
 }
 
 /**
  * @brief Metodo principale del nodo, chiamato da FF per ogni task.
  * Rice un task, lo inserisce nella inQ_ e ritorna FF_GO_ON per indicare che è
- * pronto a ricevere un altro task.
+ * pronto a ricevere un altro task. FF non passa l'EOS a svc(): la fine dello stream arriva in
+ * eosnotify().
  */
 void *ff_node_acc_t::svc(void *task) {
-   // Se il task è un EOS, propaga la sentinella alla pipeline interna.
-   if (task == FF_EOS) {
-      inQ_.push(SENTINEL);
-      return FF_EOS;
-   }
+   // Imposta l'ora di arrivo del task nel nodo, se non è già stata impostata da uno stadio
+   // precedente (TaskBatcher).
+   auto *t = static_cast<Task *>(task);
+   if (t->arrival_time == Clock::time_point{})
+      t->arrival_time = Clock::now();
+   Tracer::instant("Arrival", t->id);
 
-   // Imposta l'ora di arrivo del task nel nodo.
-   static_cast<Task *>(task)->arrival_time = std::chrono::steady_clock::now();
-
-   inQ_.push(task);
+   inQ_->push(task);
    return FF_GO_ON;
 }
 
+/**
+ * @brief Acquisisce un buffer set e invia i dati sul device, aggiornando i tempi dello stadio
+ * di Upload. Usato sia dal Producer (2 stadi) sia dal thread di Upload (3 stadi).
+ */
+void ff_node_acc_t::upload(Task *task) {
+   auto t0 = Clock::now();
+   task->buffer_idx = accelerator_->acquire_buffer_set(sizeof(int) * task->n);
+   auto t1 = Clock::now();
+   accelerator_->send_data_to_device(task);
+   auto t2 = Clock::now();
+
+   stats_->buffer_wait_ns += elapsed_ns(t0, t1);
+   stats_->stage_busy_ns[STAGE_UPLOAD] += elapsed_ns(t1, t2);
+   Tracer::complete("Buffer wait", task->id, t0, t1);
+   Tracer::complete("Upload", task->id, t1, t2);
+}
+
+/**
+ * @brief Accoda il kernel sul device, aggiornando i tempi dello stadio di Launch. Con il
+ * download asincrono accoda anche il download, dopo il quale il task non va più toccato: può
+ * essere già nella readyQ_.
+ */
+void ff_node_acc_t::launch(Task *task) {
+   // Con il download asincrono il task può essere già distrutto dal Consumer quando il Launch
+   // ne registra la traccia, quindi l'id va letto prima.
+   size_t id = task->id;
+   auto t0 = Clock::now();
+   accelerator_->execute_kernel(task);
+   if (async_download_) {
+      downloads_started_.fetch_add(1, std::memory_order_relaxed);
+      accelerator_->start_results_download(task, &ff_node_acc_t::on_download_complete, this);
+   }
+   auto t1 = Clock::now();
+   stats_->stage_busy_ns[STAGE_LAUNCH] += elapsed_ns(t0, t1);
+   Tracer::complete("Launch", id, t0, t1);
+}
+
+void ff_node_acc_t::on_download_complete(void *task, void *node) {
+   Tracer::set_thread_name("OpenCL callback");
+   Tracer::instant("Download complete", static_cast<Task *>(task)->id);
+   static_cast<ff_node_acc_t *>(node)->readyQ_->push(task);
+}
+
 /**
  * @brief Loop per il 1° stadio della pipeline: Producer (Upload + Launch).
  */
 void ff_node_acc_t::producerLoop() {
+   Tracer::set_thread_name("Producer");
    while (true) {
       // Attende un task dalla coda di input.
-      void *ptr = inQ_.pop();
+      auto t0 = Clock::now();
+      void *ptr = inQ_->pop();
+      stats_->stage_wait_ns[STAGE_UPLOAD] += elapsed_ns(t0, Clock::now());
 
       // Se riceve la sentinella, la propaga e termina.
       if (ptr == SENTINEL) {
-         readyQ_.push(SENTINEL);
+         readyQ_->push(SENTINEL);
          break;
       }
 
       auto *task = static_cast<Task *>(ptr);
 
       // Acquisisce un buffer set, invia i dati sul device e avvia il kernel.
-      task->buffer_idx = accelerator_->acquire_buffer_set();
-      accelerator_->send_data_to_device(task);
-      accelerator_->execute_kernel(task);
+      upload(task);
+      launch(task);
 
-      readyQ_.push(task);
+      if (!async_download_)
+         readyQ_->push(task);
+   }
+}
+
+/**
+ * @brief Loop per il 1° stadio della pipeline a 3 thread: Upload.
+ */
+void ff_node_acc_t::uploadLoop() {
+   Tracer::set_thread_name("Upload");
+   while (true) {
+      auto t0 = Clock::now();
+      void *ptr = inQ_->pop();
+      stats_->stage_wait_ns[STAGE_UPLOAD] += elapsed_ns(t0, Clock::now());
+
+      if (ptr == SENTINEL) {
+         launchQ_->push(SENTINEL);
+         break;
+      }
+
+      auto *task = static_cast<Task *>(ptr);
+      upload(task);
+      launchQ_->push(task);
+   }
+}
+
+/**
+ * @brief Loop per il 2° stadio della pipeline a 3 thread: Launch.
+ */
+void ff_node_acc_t::launchLoop() {
+   Tracer::set_thread_name("Launch");
+   while (true) {
+      auto t0 = Clock::now();
+      void *ptr = launchQ_->pop();
+      stats_->stage_wait_ns[STAGE_LAUNCH] += elapsed_ns(t0, Clock::now());
+
+      if (ptr == SENTINEL) {
+         readyQ_->push(SENTINEL);
+         break;
+      }
+
+      auto *task = static_cast<Task *>(ptr);
+      launch(task);
+      if (!async_download_)
+         readyQ_->push(task);
    }
 }
 
@@ -94,63 +296,117 @@ void ff_node_acc_t::producerLoop() {
  * @brief Loop per il 2° stadio della pipeline: Consumer (Download).
  */
 void ff_node_acc_t::consumerLoop() {
-   // Memorizza l'ora di completamento del task precedente.
-   std::chrono::steady_clock::time_point last_completion_time;
-   bool first_task = true;
+   Tracer::set_thread_name("Consumer");
+   bool sentinel_seen = false;
+   size_t completed = 0;
 
    while (true) {
+      // Con il download asincrono la sentinella può precedere gli ultimi task completati.
+      if (sentinel_seen && completed == downloads_started_.load(std::memory_order_relaxed)) {
+         // La pipeline è vuota. L'ultimo Consumer attivo comunica il conteggio finale.
+         stats_->consumer_finished();
+         break;
+      }
+
       // Prende un task pronto dalla coda.
-      void *ptr = readyQ_.pop();
+      auto wait_start = Clock::now();
+      void *ptr = readyQ_->pop();
+      auto download_start = Clock::now();
+      stats_->stage_wait_ns[STAGE_DOWNLOAD] += elapsed_ns(wait_start, download_start);
 
       if (ptr == SENTINEL) {
-         // La pipeline è vuota. Comunica il conteggio finale.
-         stats_->count_promise.set_value(stats_->tasks_processed.load());
-         break;
+         sentinel_seen = true;
+         continue;
       }
 
       auto *task = static_cast<Task *>(ptr);
       long long current_task_ns = 0;
 
-      // Attende il completamento del kernel e scarica i risultati sull'host.
-      accelerator_->get_results_from_device(task, current_task_ns);
-
-      auto end_time = std::chrono::steady_clock::now();
+      if (async_download_) {
+         // Il download è già completo, restano solo le operazioni sull'host.
+         accelerator_->finish_results_download(task);
+         current_task_ns = task->computed_ns;
+         ++completed;
+      } else {
+         // Attende il completamento del kernel e scarica i risultati sull'host.
+         accelerator_->get_results_from_device(task, current_task_ns);
+      }
 
-      // Calcola il tempo nel nodo per questo task.
-      auto inNode_duration =
-         std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - task->arrival_time);
+      // Tempi sul device del lancio (task o batch), con il profiling OpenCL.
+      if (task->profiled)
+         stats_->record_device_times(task->device_ns);
 
-      // Calcola il tempo dall'ultimo completamento.
-      if (!first_task) {
-         auto inter_completion_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            end_time - last_completion_time);
-         stats_->inter_completion_time_ns += inter_completion_duration.count();
-      } else
-         first_task = false;
+      // Con un batch copia i risultati nei vettori di output dei task che contiene.
+      if (task->batch)
+         TaskBatcher::scatter_results(*task);
 
-      last_completion_time = end_time;
+      auto end_time = std::chrono::steady_clock::now();
+      stats_->stage_busy_ns[STAGE_DOWNLOAD] += elapsed_ns(download_start, end_time);
+      Tracer::complete("Download", task->id, download_start, end_time);
 
-      // Aggiorna le statistiche.
-      stats_->computed_ns += current_task_ns;
-      stats_->total_InNode_time_ns += inNode_duration.count();
-      stats_->tasks_processed++;
+      // Aggiorna le statistiche (tempo nel nodo, tempo dall'ultimo completamento, ecc.).
+      auto arrival_time = task->arrival_time;
+      if (task->batch)
+         TaskBatcher::record_members(*task, *stats_, end_time, current_task_ns);
+      else
+         stats_->record_task(arrival_time, end_time, current_task_ns);
 
       accelerator_->release_buffer_set(task->buffer_idx);
-      delete task;
+      hand_off(task);
+
+      if (load_)
+         load_->record_completion(arrival_time, end_time);
    }
 }
 
 /**
- * @brief Metodo di terminazione, chiamato da FF. Invia la sentinella ai
- * thread interni e attende la loro terminazione.
+ * @brief Rilascia il task completato o, con forward_output_, lo invia allo stadio successivo.
+ * Un batch viene scomposto nei suoi task, che proseguono da soli, e il batch distrutto.
+ *
+ * ff_send_out viene chiamata dal thread Consumer, non dal thread FF del nodo: è sicuro perché
+ * il canale di uscita ha un solo produttore. svc() non invia mai nulla (restituisce sempre
+ * FF_GO_ON) e FF accoda l'EOS solo dopo eosnotify(), che attende la terminazione del
+ * Consumer: nessun invio di questo thread segue o si sovrappone all'EOS.
  */
-void ff_node_acc_t::svc_end() {
-   inQ_.push(SENTINEL);
+void ff_node_acc_t::hand_off(Task *task) {
+   if (task->batch) {
+      for (Task *member : task->batch->members)
+         hand_off(member);
+      task->batch->members.clear();
+      release_task(task);
+   } else if (forward_output_)
+      ff_send_out(task);
+   else
+      release_task(task);
+}
+
+void ff_node_acc_t::stop_internal_pipeline() {
+   if (stopped_)
+      return;
+   stopped_ = true;
+   inQ_->push(SENTINEL);
 
    if (producerTh_.joinable())
       producerTh_.join();
+   if (launcherTh_.joinable())
+      launcherTh_.join();
    if (consumerTh_.joinable())
       consumerTh_.join();
+}
 
+/**
+ * @brief Chiamato da FF alla fine dello stream, prima di propagare l'EOS. Propaga la
+ * sentinella alla pipeline interna e attende che si svuoti: con forward_output_ tutti i task
+ * vengono così inviati prima dell'EOS, e lo stadio successivo non ne perde nessuno.
+ */
+void ff_node_acc_t::eosnotify(ssize_t) { stop_internal_pipeline(); }
+
+/**
+ * @brief Metodo di terminazione, chiamato da FF. Se la pipeline interna non è già stata
+ * fermata da eosnotify() (ad esempio per un errore), invia la sentinella ai thread interni e
+ * attende la loro terminazione.
+ */
+void ff_node_acc_t::svc_end() {
+   stop_internal_pipeline();
    std::cerr << "\n[Accelerator Node] Shutdown complete.\n";
 }
\ No newline at end of file
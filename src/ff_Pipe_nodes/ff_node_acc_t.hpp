@@ -1,9 +1,11 @@
 #pragma once
 
 #include "../../include/ff_includes.hpp"
-#include "../common/BlockingQueue.hpp"
+#include "../common/IQueue.hpp"
+#include "../common/RunConfig.hpp"
 #include "../common/StatsCollector.hpp"
 #include "../common/Task.hpp"
+#include "../common/WorkerLoad.hpp"
 #include "../strategy_accelerator/accelerator/IAccelerator.hpp"
 
 #include <atomic>
@@ -11,6 +13,7 @@
 #include <iostream>
 #include <memory>
 #include <thread>
+#include <vector>
 
 /**
  * @brief Nodo FastFlow che orchestra l'offloading su un acceleratore.
@@ -23,33 +26,97 @@
  * Permette di sovrapporre le operazioni di I/O con il calcolo, nella pipeline il task 'n' è in
  * esecuzione, mentre i dati per 'n+1' vengono caricati e i risultati di 'n-1' vengono
  * scaricati.
+ *
+ * Con RunConfig::acc_stages = 3 il Producer viene diviso in due thread (Upload e Launch),
+ * ognuno con la propria coda. Per ogni stadio vengono misurati il tempo di lavoro e quello di
+ * attesa, per individuare lo stadio collo di bottiglia.
+ *
+ * Con RunConfig::completion = Callback il Launch accoda anche il download, che non blocca, e
+ * l'acceleratore inserisce il task nella readyQ_ dal thread del runtime quando il download è
+ * completo. Il Consumer gestisce così solo task finiti, nell'ordine in cui finiscono.
+ *
+ * L'inizializzazione dell'acceleratore e i task di warm-up (RunConfig::warmup_tasks) vengono
+ * eseguiti da prepare(), che i runner chiamano prima di avviare la misura del tempo; se non è
+ * stato chiamato, lo fa svc_init().
+ *
+ * Di default il nodo è terminale e il Consumer rilascia i task completati. Con
+ * set_forward_output(true) il Consumer li invia invece allo stadio successivo della pipeline
+ * FF con ff_send_out (i task di un batch uno per uno), senza copie: il nodo può essere seguito
+ * dal collector di una farm, da stadi CPU o da un altro nodo ff_node_acc_t. svc() non invia
+ * mai nulla, quindi il Consumer è l'unico produttore del canale di uscita, e eosnotify()
+ * attende lo svuotamento della pipeline interna prima che FF propaghi l'EOS.
  */
 class ff_node_acc_t : public ff_node {
  public:
-   explicit ff_node_acc_t(IAccelerator *acc, StatsCollector *stats);
+   explicit ff_node_acc_t(IAccelerator *acc, StatsCollector *stats,
+                          const RunConfig &config = RunConfig(), WorkerLoad *load = nullptr);
    ~ff_node_acc_t() override;
 
+   // Inizializza l'acceleratore ed esegue i task di warm-up, fuori dalle statistiche.
+   bool prepare();
+   // Esegue prepare() su tutti i nodi in parallelo, come farebbero i nodi di una farm.
+   static bool prepare_all(const std::vector<ff_node_acc_t *> &nodes);
+
+   // Invia i task completati allo stadio successivo invece di rilasciarli (prima di run).
+   // Gli invii partono dal thread Consumer, unico produttore del canale di uscita: svc() non
+   // deve mai restituire un task, e l'EOS segue eosnotify(), che attende il Consumer.
+   void set_forward_output(bool forward) { forward_output_ = forward; }
+
  protected:
    int svc_init() override;
    void *svc(void *t) override;
+   void eosnotify(ssize_t id = -1) override;
    void svc_end() override;
 
  private:
    // Sentinella usata per segnalare la fine dello stream di dati nelle code interne ai thread.
    static void *const SENTINEL;
 
-   // Loops dei 2 stadi della pipeline interna.
+   // Loops degli stadi della pipeline interna (2 o 3 thread).
    void producerLoop();
+   void uploadLoop();
+   void launchLoop();
    void consumerLoop();
 
+   // Lavoro degli stadi di Upload e Launch, con misura dei tempi.
+   void upload(Task *task);
+   void launch(Task *task);
+
+   // Esegue un task di warm-up in modo sincrono, senza la pipeline interna.
+   void run_warmup_task(Task *task);
+
+   // Rilascia il task completato o lo invia allo stadio successivo (forward_output_).
+   void hand_off(Task *task);
+
+   // Invia la sentinella alla pipeline interna e attende la terminazione dei suoi thread.
+   void stop_internal_pipeline();
+
+   // Callback di completamento del download asincrono: inserisce il task nella readyQ_.
+   static void on_download_complete(void *task, void *node);
+
    // Puntatori all'acceleratore e all'oggetto per le statistiche.
    IAccelerator *accelerator_;
    StatsCollector *stats_;
+   WorkerLoad *load_; // Carico del worker quando il nodo fa parte di una farm, o nullptr
+   bool three_stages_; // true se Upload e Launch girano su thread separati
+   bool async_download_; // true se il download è asincrono (RunConfig::completion)
+   size_t warmup_tasks_; // Task di warm-up da eseguire in prepare()
+   size_t warmup_n_;     // Dimensione dei task di warm-up (RunConfig::expected_n)
+   bool prepared_{false};
+   bool forward_output_{false}; // true se i task completati proseguono nella pipeline FF
+   bool stopped_{false};        // true dopo stop_internal_pipeline()
+
+   // Download asincroni avviati dal Launch, confrontati dal Consumer con i task completati
+   // per sapere quando, dopo la sentinella, non arriveranno altri task.
+   std::atomic<size_t> downloads_started_{0};
 
-   // Code per i task in ingresso dalla pipeline FF e per i task pronti per il download dal
-   // device all'host.
-   BlockingQueue<void *> inQ_;
-   BlockingQueue<void *> readyQ_;
+   // Code per i task in ingresso dalla pipeline FF, per i task caricati in attesa del lancio
+   // (solo con 3 stadi) e per i task pronti per il download dal device all'host (o, con il
+   // download asincrono, per i task completati). L'implementazione (bloccante o lock-free) è
+   // scelta a runtime.
+   std::unique_ptr<IQueue<void *>> inQ_;
+   std::unique_ptr<IQueue<void *>> launchQ_;
+   std::unique_ptr<IQueue<void *>> readyQ_;
 
-   std::thread producerTh_, consumerTh_;
+   std::thread producerTh_, launcherTh_, consumerTh_;
 };
\ No newline at end of file
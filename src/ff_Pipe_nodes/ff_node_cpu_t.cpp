@@ -0,0 +1,50 @@
+#include "ff_node_cpu_t.hpp"
+#include "../common/TaskPool.hpp"
+#include "../common/Tracer.hpp"
+
+#include <chrono>
+
+ff_node_cpu_t::ff_node_cpu_t(const std::string &kernel_name, size_t num_threads,
+                             StatsCollector *stats, WorkerLoad *load, SimdMode simd)
+    : kernel_name_(kernel_name), kernel_fn_(select_cpu_kernel(kernel_name, simd)),
+      num_threads_(num_threads), stats_(stats), load_(load),
+      pf_(static_cast<long>(num_threads)) {}
+
+/**
+ * @brief Calcola il task su CPU e aggiorna le statistiche, come il Consumer di ff_node_acc_t.
+ */
+void *ff_node_cpu_t::svc(void *t) {
+   auto *task = static_cast<Task *>(t);
+   auto arrival_time = std::chrono::steady_clock::now();
+
+   const int *a = task->a, *b = task->b;
+   int *c = task->c;
+   pf_.parallel_for_idx(
+      0, static_cast<long>(task->n), 1, 0,
+      [&](const long first, const long last, const int) { kernel_fn_(a, b, c, first, last); },
+      static_cast<long>(num_threads_));
+
+   // Su CPU non c'è trasferimento dati: tempo di calcolo e tempo nel nodo coincidono.
+   auto end_time = std::chrono::steady_clock::now();
+   long long computed_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - arrival_time).count();
+   stats_->record_task(arrival_time, end_time, computed_ns);
+   Tracer::complete("Compute", task->id, arrival_time, end_time);
+
+   if (load_)
+      load_->record_completion(arrival_time, end_time);
+   if (forward_output_)
+      return task;
+   release_task(task);
+   return FF_GO_ON;
+}
+
+int ff_node_cpu_t::svc_init() {
+   Tracer::set_thread_name("CPU Worker");
+   return 0;
+}
+
+/**
+ * @brief Metodo di terminazione: se è l'ultimo worker attivo comunica il conteggio finale.
+ */
+void ff_node_cpu_t::svc_end() { stats_->consumer_finished(); }
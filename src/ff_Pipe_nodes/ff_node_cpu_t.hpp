@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../../include/ff_includes.hpp"
+#include "../common/StatsCollector.hpp"
+#include "../common/Task.hpp"
+#include "../common/WorkerLoad.hpp"
+#include "../strategy_cpu/SimdKernels.hpp"
+
+#include <string>
+
+/**
+ * @brief Nodo FastFlow che calcola i task su CPU, usato come worker della farm ibrida accanto
+ * ai nodi ff_node_acc_t e della farm di Cpu_FF_Stream_Runner.
+ *
+ * Ogni task viene calcolato per intero dal nodo con un ParallelFor su 'num_threads' core, con
+ * la stessa logica dei runner CPU (select_cpu_kernel). Le statistiche sono le stesse dei
+ * nodi ff_node_acc_t, così i risultati dei due tipi di worker si sommano.
+ */
+class ff_node_cpu_t : public ff_node {
+ public:
+   /**
+    * @param kernel_name Nome del kernel da eseguire ('vecAdd', 'polynomial_op', ...).
+    * @param num_threads Numero di thread del ParallelFor usato per ogni task.
+    * @param stats Puntatore all'oggetto per le statistiche finali.
+    * @param load Carico del worker, aggiornato al completamento di ogni task (nullptr se la
+    * farm non ha uno scheduler che lo usa).
+    * @param simd Set di istruzioni vettoriali del kernel (vedi SimdKernels).
+    */
+   ff_node_cpu_t(const std::string &kernel_name, size_t num_threads, StatsCollector *stats,
+                 WorkerLoad *load, SimdMode simd = SimdMode::Auto);
+
+   // Invia i task calcolati allo stadio successivo invece di rilasciarli, come ff_node_acc_t.
+   void set_forward_output(bool forward) { forward_output_ = forward; }
+
+ protected:
+   int svc_init() override;
+   void *svc(void *t) override;
+   void svc_end() override;
+
+ private:
+   std::string kernel_name_;
+   KernelRangeFn kernel_fn_;
+   size_t num_threads_;
+   StatsCollector *stats_;
+   WorkerLoad *load_;
+   bool forward_output_{false}; // true se i task calcolati proseguono nella pipeline FF
+   ff::ParallelFor pf_;
+};
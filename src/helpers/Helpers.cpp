@@ -3,6 +3,8 @@
 #include "../common/device_types.h"
 #include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 
 /**
  * Helper interno per estrarre il nome del file da un percorso, senza
@@ -38,31 +40,269 @@ static size_t parse_numeric_arg(const char *arg_str) {
    return static_cast<size_t>(value);
 }
 
+/**
+ * Helper interno per il parsing di un'opzione '--chiave=valore' in RunConfig.
+ */
+static void parse_run_option(const std::string &arg, RunConfig &config) {
+   size_t eq_pos = arg.find('=');
+   if (eq_pos == std::string::npos)
+      throw std::invalid_argument("L'opzione '" + arg +
+                                  "' deve avere la forma --chiave=valore.");
+
+   std::string key = arg.substr(2, eq_pos - 2);
+   std::string value = arg.substr(eq_pos + 1);
+
+   if (key == "queue") {
+      if (value == "blocking")
+         config.queue_kind = QueueKind::Blocking;
+      else if (value == "spsc")
+         config.queue_kind = QueueKind::Spsc;
+      else if (value == "mpmc")
+         config.queue_kind = QueueKind::Mpmc;
+      else
+         throw std::invalid_argument("Valore non valido per --queue: '" + value + "'.");
+
+   } else if (key == "wait") {
+      if (value == "spin")
+         config.wait_kind = WaitKind::BusySpin;
+      else if (value == "yield")
+         config.wait_kind = WaitKind::SpinYield;
+      else if (value == "park")
+         config.wait_kind = WaitKind::SpinPark;
+      else
+         throw std::invalid_argument("Valore non valido per --wait: '" + value + "'.");
+
+   } else if (key == "acc-stages") {
+      config.acc_stages = parse_numeric_arg(value.c_str());
+      if (config.acc_stages != 2 && config.acc_stages != 3)
+         throw std::invalid_argument("--acc-stages deve essere 2 o 3.");
+
+   } else if (key == "completion") {
+      if (value == "blocking")
+         config.completion = CompletionMode::Blocking;
+      else if (value == "callback")
+         config.completion = CompletionMode::Callback;
+      else
+         throw std::invalid_argument("Valore non valido per --completion: '" + value + "'.");
+
+   } else if (key == "pipeline-depth") {
+      config.pipeline_depth = parse_numeric_arg(value.c_str());
+
+   } else if (key == "acc-workers") {
+      config.acc_workers = parse_numeric_arg(value.c_str());
+
+   } else if (key == "cpu-workers") {
+      config.cpu_workers = parse_numeric_arg(value.c_str());
+
+   } else if (key == "cpu-threads") {
+      config.cpu_threads = parse_numeric_arg(value.c_str());
+
+   } else if (key == "simd") {
+      if (value == "auto")
+         config.simd = SimdMode::Auto;
+      else if (value == "off")
+         config.simd = SimdMode::Off;
+      else if (value == "sse4.2")
+         config.simd = SimdMode::Sse42;
+      else if (value == "avx2")
+         config.simd = SimdMode::Avx2;
+      else if (value == "avx512")
+         config.simd = SimdMode::Avx512;
+      else
+         throw std::invalid_argument("Valore non valido per --simd: '" + value + "'.");
+
+   } else if (key == "farm-inflight") {
+      config.acc_max_in_flight = parse_numeric_arg(value.c_str());
+      if (config.acc_max_in_flight == 0)
+         throw std::invalid_argument("--farm-inflight deve essere maggiore di 0.");
+
+   } else if (key == "chunk-size") {
+      config.chunk_size = parse_numeric_arg(value.c_str());
+
+   } else if (key == "cl-queue") {
+      if (value == "in_order")
+         config.cl_queue_mode = ClQueueMode::InOrder;
+      else if (value == "out_of_order")
+         config.cl_queue_mode = ClQueueMode::OutOfOrder;
+      else if (value == "split")
+         config.cl_queue_mode = ClQueueMode::Split;
+      else
+         throw std::invalid_argument("Valore non valido per --cl-queue: '" + value + "'.");
+
+   } else if (key == "mem") {
+      if (value == "copy")
+         config.mem_mode = MemMode::Copy;
+      else if (value == "pinned")
+         config.mem_mode = MemMode::Pinned;
+      else if (value == "zero_copy")
+         config.mem_mode = MemMode::ZeroCopy;
+      else
+         throw std::invalid_argument("Valore non valido per --mem: '" + value + "'.");
+
+   } else if (key == "profile") {
+      if (value == "on" || value == "1")
+         config.profile = true;
+      else if (value == "off" || value == "0")
+         config.profile = false;
+      else
+         throw std::invalid_argument("Valore non valido per --profile: '" + value + "'.");
+
+   } else if (key == "pool") {
+      config.pool_size = (value == "auto") ? 0 : parse_numeric_arg(value.c_str());
+      if (config.pool_size == 0 && value != "auto")
+         throw std::invalid_argument("--pool deve essere maggiore di 0 o 'auto'.");
+
+   } else if (key == "mem-budget-mb") {
+      config.mem_budget_mb = parse_numeric_arg(value.c_str());
+
+   } else if (key == "mixed-n") {
+      config.mixed_n = parse_numeric_arg(value.c_str());
+      if (config.mixed_n == 0 || config.mixed_n > 32)
+         throw std::invalid_argument("--mixed-n deve essere compreso fra 1 e 32.");
+
+   } else if (key == "batch") {
+      config.batch_auto = (value == "auto");
+      config.batch_size = config.batch_auto ? 1 : parse_numeric_arg(value.c_str());
+      if (config.batch_size == 0)
+         throw std::invalid_argument("--batch deve essere maggiore di 0 o 'auto'.");
+
+   } else if (key == "batch-timeout-us") {
+      config.batch_timeout_us = parse_numeric_arg(value.c_str());
+
+   } else if (key == "warmup") {
+      config.warmup_tasks = parse_numeric_arg(value.c_str());
+
+   } else if (key == "task-pool") {
+      config.task_pool = (value != "off");
+      config.task_pool_slots =
+         (value == "auto" || value == "off") ? 0 : parse_numeric_arg(value.c_str());
+      if (config.task_pool && config.task_pool_slots == 0 && value != "auto")
+         throw std::invalid_argument("--task-pool deve essere maggiore di 0, 'auto' o 'off'.");
+
+   } else if (key == "source") {
+      if (value.empty())
+         throw std::invalid_argument("--source richiede il percorso del file di input.");
+      config.source_path = value;
+
+   } else if (key == "source-mode") {
+      if (value == "mmap")
+         config.source_mode = SourceMode::Mmap;
+      else if (value == "prefetch")
+         config.source_mode = SourceMode::Prefetch;
+      else
+         throw std::invalid_argument("Valore non valido per --source-mode: '" + value + "'.");
+
+   } else if (key == "read-ahead") {
+      config.read_ahead = parse_numeric_arg(value.c_str());
+      if (config.read_ahead == 0)
+         throw std::invalid_argument("--read-ahead deve essere maggiore di 0.");
+
+   } else if (key == "sink") {
+      if (value.empty())
+         throw std::invalid_argument("--sink richiede il percorso del file di output.");
+      config.sink_path = value;
+
+   } else if (key == "farm-mode") {
+      if (value == "device")
+         config.farm_mode = FarmMode::Device;
+      else if (value == "queue")
+         config.farm_mode = FarmMode::Queue;
+      else
+         throw std::invalid_argument("Valore non valido per --farm-mode: '" + value + "'.");
+
+   } else if (key == "cl-device-type") {
+      if (value == "gpu")
+         config.cl_device_kind = OpenClDeviceKind::Gpu;
+      else if (value == "cpu")
+         config.cl_device_kind = OpenClDeviceKind::Cpu;
+      else if (value == "accelerator")
+         config.cl_device_kind = OpenClDeviceKind::Accelerator;
+      else if (value == "all")
+         config.cl_device_kind = OpenClDeviceKind::All;
+      else
+         throw std::invalid_argument("Valore non valido per --cl-device-type: '" + value +
+                                     "'.");
+
+   } else if (key == "trace") {
+      if (value.empty())
+         throw std::invalid_argument("--trace richiede il percorso del file di traccia.");
+      config.trace_path = value;
+
+   } else if (key == "kernel-cache") {
+      if (value.empty())
+         throw std::invalid_argument("--kernel-cache richiede una cartella oppure 'off'.");
+      config.kernel_cache_dir = (value == "off") ? "" : value;
+
+   } else if (key == "output") {
+      if (value == "text")
+         config.output_format = OutputFormat::Text;
+      else if (value == "json")
+         config.output_format = OutputFormat::Json;
+      else if (value == "csv")
+         config.output_format = OutputFormat::Csv;
+      else
+         throw std::invalid_argument("Valore non valido per --output: '" + value + "'.");
+
+   } else if (key == "output-file") {
+      if (value.empty())
+         throw std::invalid_argument("--output-file richiede il percorso del file.");
+      config.output_path = value;
+
+   } else if (key == "queue-capacity") {
+      config.queue_capacity = parse_numeric_arg(value.c_str());
+      if (config.queue_capacity == 0)
+         throw std::invalid_argument("--queue-capacity deve essere maggiore di 0.");
+
+   } else
+      throw std::invalid_argument("Opzione sconosciuta: '--" + key + "'.");
+}
+
 /**
  * Funzione per il parsing e il setting di default degli argomenti della riga di comando.
+ * Gli argomenti che iniziano con '--' sono opzioni facoltative e possono comparire in qualsiasi
+ * posizione, gli altri sono posizionali.
  */
 void parse_args(int argc, char *argv[], size_t &N, size_t &NUM_TASKS, std::string &device_type,
-                std::string &kernel_path, std::string &kernel_name) {
+                std::string &kernel_path, std::string &kernel_name, RunConfig &config) {
 
    N = 1000000;
    NUM_TASKS = 20;
    device_type = device::CPU_FF;
    kernel_path = "";
    kernel_name = "";
+   config = RunConfig();
 
    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) {
       print_usage(argv[0]);
       exit(0);
    }
 
-   if (argc > 5)
+   // Separa le opzioni '--chiave=valore' dagli argomenti posizionali.
+   std::vector<char *> positional;
+   for (int i = 1; i < argc; ++i) {
+      std::string arg(argv[i]);
+      if (arg.rfind("--", 0) != 0) {
+         positional.push_back(argv[i]);
+         continue;
+      }
+
+      try {
+         parse_run_option(arg, config);
+      } catch (const std::exception &e) {
+         std::cerr << "\n[ERROR] " << e.what() << "\n";
+         print_usage(argv[0]);
+         exit(EXIT_FAILURE);
+      }
+   }
+
+   if (positional.size() > 4)
       std::cerr << "[WARNING] Too many arguments provided. Ignoring extras.\n";
 
    try {
-      if (argc > 1)
-         N = parse_numeric_arg(argv[1]);
-      if (argc > 2)
-         NUM_TASKS = parse_numeric_arg(argv[2]);
+      if (positional.size() > 0)
+         N = parse_numeric_arg(positional[0]);
+      if (positional.size() > 1)
+         NUM_TASKS = parse_numeric_arg(positional[1]);
    } catch (const std::invalid_argument &e) {
       std::cerr << "\n[ERROR] Not valid args for N or NUM_TASKS. Integer values required.\n";
       print_usage(argv[0]);
@@ -75,15 +315,16 @@ void parse_args(int argc, char *argv[], size_t &N, size_t &NUM_TASKS, std::strin
       print_usage(argv[0]);
       exit(EXIT_FAILURE);
    }
+   config.expected_n = N;
 
-   if (argc > 3)
-      device_type = argv[3];
-   if (argc > 4)
-      kernel_path = argv[4];
+   if (positional.size() > 2)
+      device_type = positional[2];
+   if (positional.size() > 3)
+      kernel_path = positional[3];
 
    // Per GPU e FPGA, se non specifico un kernel di default imposta polynomial_op.
    if (kernel_path.empty()) {
-      if (device_type == device::GPU_CL)
+      if (device_type == device::GPU_CL || device_type == device::HYBRID)
          kernel_path = "kernels/gpu/polynomial_op.cl";
       else if (device_type == device::GPU_MTL)
          kernel_path = "kernels/gpu/polynomial_op.metal";
@@ -93,12 +334,13 @@ void parse_args(int argc, char *argv[], size_t &N, size_t &NUM_TASKS, std::strin
 
    // Per GPU e FPGA, estraggo il nome del kernel dal percorso specificato.
    if (device_type == device::GPU_CL || device_type == device::FPGA ||
-       device_type == device::GPU_MTL)
+       device_type == device::GPU_MTL || device_type == device::HYBRID)
       kernel_name = extractKernelName(kernel_path);
 
    // Per CPU, se non specifico un kernel imposta polynomial_op, altrimenti lo estrae dal nome.
    if (kernel_path.empty() &&
-       (device_type == device::CPU_FF || device_type == device::CPU_OMP))
+       (device_type == device::CPU_FF || device_type == device::CPU_OMP ||
+        device_type == device::CPU_FF_STREAM || device_type == device::CPU_THREAD))
       kernel_name = "polynomial_op";
    else
       kernel_name = extractKernelName(kernel_path);
@@ -113,10 +355,12 @@ void print_configuration(size_t N, size_t NUM_TASKS, const std::string &device_t
    std::cout << "\nConfiguration: N=" << N << ", NUM_TASKS=" << NUM_TASKS
              << ", Device=" << device_type;
 
-   if (device_type == "cpu_ff" || device_type == "cpu_omp")
+   if (device_type == "cpu_ff" || device_type == "cpu_omp" || device_type == "cpu_ff_stream" ||
+       device_type == "cpu_thread")
       std::cout << ", Kernel=" << kernel_name;
 
-   if (device_type == "gpu_opencl" || device_type == "gpu_metal" || device_type == "fpga")
+   if (device_type == "gpu_opencl" || device_type == "gpu_metal" || device_type == "fpga" ||
+       device_type == "hybrid")
       std::cout << ", Using " << kernel_path;
 
    std::cout << "\n\n";
@@ -126,15 +370,79 @@ void print_configuration(size_t N, size_t NUM_TASKS, const std::string &device_t
  * Funzione per stampare le istruzioni d'uso.
  */
 void print_usage(const char *prog_name) {
-   std::cerr << "\nUsage: " << prog_name << " N NUM_TASKS DEVICE [KERNEL]\n\n"
+   std::cerr << "\nUsage: " << prog_name
+             << " N NUM_TASKS DEVICE [KERNEL] [--OPTION=VALUE ...]\n\n"
              << "   (Gli argomenti sono posizionali e devono essere forniti in questo "
                 "ordine,\n    gli argomenti fra [] sono opzionali)\n\n"
              << "  N            : Size of the vectors (default: 1,000,000)\n"
              << "  NUM_TASKS    : Number of tasks to run (default: 20)\n"
-             << "  DEVICE       : 'cpu_ff', 'cpu_omp', 'gpu_opencl', 'gpu_metal' or 'fpga' "
-                "(default: 'cpu_ff').\n"
+             << "  DEVICE       : 'cpu_ff', 'cpu_ff_stream', 'cpu_omp', 'gpu_opencl', "
+                "'gpu_metal', 'fpga', 'hybrid' or 'cpu_thread' (default: 'cpu_ff').\n"
              << "  KERNEL  : Path to the kernel file for accelerators (.cl, .xclbin, .metal)\n"
              << "                 or kernel name for CPU ('vecAdd', 'polynomial_op', etc.)\n"
+             << "\nOptions (accelerators):\n"
+             << "  --queue=blocking|spsc|mpmc : Internal queues of ff_node_acc_t "
+                "(default: blocking)\n"
+             << "  --wait=spin|yield|park     : Wait policy of lock-free queues (default: park)\n"
+             << "  --queue-capacity=N         : Capacity of lock-free queues (default: 1024)\n"
+             << "  --acc-stages=2|3           : Internal threads of ff_node_acc_t, "
+                "upload+launch/download or upload/launch/download (default: 2)\n"
+             << "  --pipeline-depth=K         : Max tasks queued between internal stages "
+                "(default: queue capacity)\n"
+             << "  --completion=blocking|callback : Download stage waits for each task in "
+                "order or handles tasks as they finish (default: blocking)\n"
+             << "  --acc-workers=N            : gpu_opencl and cpu_thread farm of N "
+                "ff_node_acc_t workers, 0 = one per device (default: 1)\n"
+             << "  --farm-mode=device|queue   : One worker per device or all workers on "
+                "device 0 with own queues (default: device)\n"
+             << "  --cl-device-type=gpu|cpu|accelerator|all : OpenCL device type used by "
+                "gpu_opencl (default: gpu)\n"
+             << "  --cpu-workers=N            : hybrid and cpu_ff_stream farms, CPU workers "
+                "(tasks computed at once) (default: 1)\n"
+             << "  --cpu-threads=T            : hybrid and cpu_ff_stream farms, threads per "
+                "CPU worker; cpu_thread, device threads; 0 = the free cores (default: 0)\n"
+             << "  --farm-inflight=K          : hybrid farm, max tasks in flight per "
+                "accelerator worker (default: 4)\n"
+             << "  --simd=auto|off|sse4.2|avx2|avx512 : CPU kernels of cpu_ff, cpu_ff_stream, "
+                "cpu_omp, cpu_thread and hybrid, auto = widest supported (default: auto)\n"
+             << "  --chunk-size=N             : gpu_opencl and fpga, split each task in "
+                "chunks of N elements, 0 = off (default: 0)\n"
+             << "  --cl-queue=in_order|out_of_order|split : gpu_opencl and fpga command "
+                "queues (default: in_order)\n"
+             << "  --mem=copy|pinned|zero_copy : gpu_opencl and fpga host memory for "
+                "transfers (default: copy)\n"
+             << "  --profile=on|off           : gpu_opencl, fpga and cpu_thread, device times "
+                "from OpenCL profiling events (default: off)\n"
+             << "  --pool=auto|K              : gpu_opencl, fpga and cpu_thread buffer sets, "
+                "auto = adaptive (default: auto)\n"
+             << "  --mem-budget-mb=M          : Device memory for the buffer pool, 0 = 3/4 of "
+                "the device (default: 0)\n"
+             << "  --mixed-n=K                : Task sizes cycle through N, N/2, ..., "
+                "N/2^(K-1) (default: 1, all N)\n"
+             << "  --batch=K|auto             : Pack K small tasks into one kernel launch, "
+                "auto = by N (default: 1, off)\n"
+             << "  --batch-timeout-us=T       : Max wait of the first task of a batch "
+                "(default: 1000)\n"
+             << "  --warmup=K                 : Tasks run by every accelerator before the "
+                "timed run, not in the stats (default: 0)\n"
+             << "  --task-pool=auto|off|K     : Recycled tasks with their own input/output "
+                "vectors, off = shared vectors (default: auto)\n"
+             << "  --source=FILE              : Read the a/b vectors of every task from FILE "
+                "(default: generated)\n"
+             << "  --source-mode=MODE         : How FILE is read: 'mmap' or 'prefetch' "
+                "(default: mmap)\n"
+             << "  --read-ahead=K             : Tasks of FILE read ahead of the pipeline "
+                "(default: 4)\n"
+             << "  --sink=FILE                : Write the output vector of every task to FILE "
+                "(default: off)\n"
+             << "  --trace=FILE.json          : Write the timeline of every task as Chrome "
+                "Trace Event JSON, for Perfetto (default: off)\n"
+             << "  --kernel-cache=DIR|off     : Cache of compiled OpenCL programs "
+                "(default: ~/.cache/tesi-exec)\n"
+             << "  --output=text|json|csv     : Results as readable metrics or as one JSON "
+                "object / CSV row with every field (default: text)\n"
+             << "  --output-file=FILE         : Append the json/csv results to FILE instead "
+                "of stdout\n"
              << "\nExample (GPU): " << prog_name
              << " 16777216 100 gpu_opencl kernels/gpu/heavy_compute_kernel.cl\n"
              << "Example (CPU): " << prog_name << " 16777216 100 cpu_ff vecAdd\n";
@@ -167,9 +475,99 @@ PerformanceData calculate_metrics(const ComputeResult &results) {
    metrics.throughput =
       (metrics.elapsed_s > 0) ? (results.tasks_completed / metrics.elapsed_s) : 0;
 
+   // Occupazione e tempo medio per task di ogni stadio della pipeline interna.
+   for (size_t s = 0; s < NUM_STAGES; ++s) {
+      metrics.stage_occupancy[s] =
+         (results.elapsed_ns > 0) ? double(results.stage_busy_ns[s]) / results.elapsed_ns : 0;
+      metrics.stage_avg_busy_ms[s] =
+         (results.stage_busy_ns[s] / results.tasks_completed) / 1.0e6;
+   }
+   metrics.avg_buffer_wait_ms = (results.buffer_wait_ns / results.tasks_completed) / 1.0e6;
+   metrics.buffer_sets_peak = results.buffer_sets_peak;
+   metrics.buffer_sets_final = results.buffer_sets_final;
+
+   // Tempi medi per lancio misurati sul device (solo con il profiling).
+   metrics.profiled_launches = results.profiled_launches;
+   if (results.profiled_launches > 0)
+      for (size_t t = 0; t < NUM_DEVICE_TIMES; ++t)
+         metrics.avg_device_ms[t] = (results.device_ns[t] / results.profiled_launches) / 1.0e6;
+
+   metrics.in_node_latency = results.in_node_latency;
+   metrics.computed_latency = results.computed_latency;
+   metrics.inter_completion_latency = results.inter_completion_latency;
+
+   metrics.startup_ms = results.startup_ns / 1.0e6;
+   metrics.warmup_ms = results.warmup_ns / 1.0e6;
+   metrics.warmup_tasks = results.warmup_tasks;
+   metrics.first_task_ms = results.first_task_ns / 1.0e6;
+   metrics.program_build_ms = results.program_build_ns / 1.0e6;
+   metrics.programs_cached = results.programs_cached;
+   metrics.programs_compiled = results.programs_compiled;
+
    return metrics;
 }
 
+/**
+ * Helper interno per stampare una riga di percentili di latenza, in ms.
+ */
+static void print_latency_row(const char *name, const LatencyPercentiles &latency) {
+   std::cout << "   " << name << ": p50 " << latency.p50_ns / 1.0e6 << ", p90 "
+             << latency.p90_ns / 1.0e6 << ", p99 " << latency.p99_ns / 1.0e6 << ", p99.9 "
+             << latency.p999_ns / 1.0e6 << ", max " << latency.max_ns / 1.0e6 << "\n";
+}
+
+/**
+ * Helper interno per stampare i percentili delle latenze per task.
+ */
+static void print_latency_metrics(const PerformanceData &metrics) {
+   std::cout << "Latency Percentiles (ms):\n"
+             << "   (Distribuzione per task, errore relativo < 1%)\n";
+   print_latency_row("In_Node", metrics.in_node_latency);
+   print_latency_row("Compute", metrics.computed_latency);
+   if (metrics.inter_completion_latency.count > 0)
+      print_latency_row("Inter-completion", metrics.inter_completion_latency);
+   std::cout << "------------------------------------------------------------------\n";
+}
+
+/**
+ * Helper interno per stampare occupazione e tempo medio di ogni stadio della pipeline interna
+ * di ff_node_acc_t, indicando lo stadio collo di bottiglia (quello più occupato).
+ */
+static void print_stage_metrics(const PerformanceData &metrics) {
+   static const char *STAGE_NAMES[NUM_STAGES] = {"Upload", "Launch", "Download"};
+
+   size_t bottleneck = 0;
+   for (size_t s = 1; s < NUM_STAGES; ++s)
+      if (metrics.stage_occupancy[s] > metrics.stage_occupancy[bottleneck])
+         bottleneck = s;
+
+   std::cout << "Stage Occupancy:\n"
+             << "   (Frazione del tempo totale in cui ogni stadio interno lavora)\n";
+   for (size_t s = 0; s < NUM_STAGES; ++s)
+      std::cout << "   " << STAGE_NAMES[s] << ": " << metrics.stage_occupancy[s] * 100.0
+                << " % (" << metrics.stage_avg_busy_ms[s] << " ms/task)\n";
+   std::cout << "   Buffer set wait: " << metrics.avg_buffer_wait_ms << " ms/task\n";
+   if (metrics.buffer_sets_final > 0)
+      std::cout << "   Buffer sets: " << metrics.buffer_sets_peak << " in use at peak, "
+                << metrics.buffer_sets_final << " in pool\n";
+   std::cout << "   Bottleneck stage: " << STAGE_NAMES[bottleneck] << "\n"
+             << "------------------------------------------------------------------\n";
+
+   if (metrics.profiled_launches > 0) {
+      std::cout << "Device Timing (OpenCL profiling, " << metrics.profiled_launches
+                << " launches):\n"
+                << "   (Tempi medi per lancio misurati sul device dagli eventi)\n"
+                << "   H2D: " << metrics.avg_device_ms[DEVICE_H2D] << " ms\n"
+                << "   Kernel: " << metrics.avg_device_ms[DEVICE_KERNEL] << " ms\n"
+                << "   D2H: " << metrics.avg_device_ms[DEVICE_D2H] << " ms\n"
+                << "   Queued (QUEUED -> SUBMIT): " << metrics.avg_device_ms[DEVICE_QUEUED]
+                << " ms\n"
+                << "   Submitted (SUBMIT -> START): "
+                << metrics.avg_device_ms[DEVICE_SUBMITTED] << " ms\n"
+                << "------------------------------------------------------------------\n";
+   }
+}
+
 /**
  * Funzione per stampare le statistiche finali.
  */
@@ -210,7 +608,7 @@ void print_metrics(size_t N, size_t NUM_TASKS, const std::string &device_type,
                 << (final_count == NUM_TASKS ? " (SUCCESS)" : " (FAILURE)") << "\n"
                 << "------------------------------------------------------------------\n";
 
-   } else
+   } else {
       std::cout << ", Kernel=" << kernel_name
                 << ")\n------------------------------------------------------------------"
                    "\n"
@@ -224,10 +622,34 @@ void print_metrics(size_t N, size_t NUM_TASKS, const std::string &device_type,
                 << "Avg Overhead Time: " << metrics.avg_overhead_ms << " ms/task\n"
                 << "   (Costo medio di gestione: trasferimento dati, uso delle code, etc.)\n\n"
                 << "Throughput: " << metrics.throughput << " tasks/sec\n"
-                << "   (Task totali processati al secondo)\n\n"
+                << "   (Task totali processati al secondo, a regime)\n\n"
                 << "Total Time Elapsed: " << metrics.elapsed_s << " s\n"
-                << "------------------------------------------------------------------\n"
-                << "Tasks processed: " << final_count << " / " << NUM_TASKS
+                << "   (Dall'avvio della pipeline, esclusi avvio e warm-up)\n"
+                << "------------------------------------------------------------------\n";
+
+      // La farm di cpu_ff_stream non ha acceleratori da inizializzare né stadi interni.
+      const bool accelerators = device_type != device::CPU_FF_STREAM;
+      if (accelerators)
+         std::cout << "Startup Time: " << metrics.startup_ms << " ms\n"
+                   << "   (Inizializzazione degli acceleratori, prima della misura)\n";
+      if (metrics.programs_cached + metrics.programs_compiled > 0)
+         std::cout << "   Kernel build: " << metrics.program_build_ms << " ms ("
+                   << metrics.programs_cached << " from cache, " << metrics.programs_compiled
+                   << " compiled)\n";
+      if (metrics.warmup_tasks > 0)
+         std::cout << "   Warm-up: " << metrics.warmup_ms << " ms (" << metrics.warmup_tasks
+                   << " tasks per accelerator)\n";
+      std::cout << (accelerators ? "\n" : "") << "First Task Latency: " << metrics.first_task_ms
+                << " ms\n"
+                << "   (Dall'avvio della pipeline al completamento del primo task)\n"
+                << "------------------------------------------------------------------\n";
+
+      print_latency_metrics(metrics);
+      if (accelerators)
+         print_stage_metrics(metrics);
+
+      std::cout << "Tasks processed: " << final_count << " / " << NUM_TASKS
                 << (final_count == NUM_TASKS ? " (SUCCESS)" : " (FAILURE)") << "\n"
                 << "------------------------------------------------------------------\n";
+   }
 }
\ No newline at end of file
@@ -2,14 +2,16 @@
 
 #include "../common/ComputeResult.hpp"
 #include "../common/PerformanceData.hpp"
+#include "../common/RunConfig.hpp"
 #include <cstddef>
 #include <string>
 
 /**
  * Funzione per il parsing e il setting di default degli argomenti della riga di comando.
+ * Le opzioni facoltative '--chiave=valore' vengono salvate in config.
  */
 void parse_args(int argc, char *argv[], size_t &N, size_t &NUM_TASKS, std::string &device_type,
-                std::string &kernel_path, std::string &kernel_name);
+                std::string &kernel_path, std::string &kernel_name, RunConfig &config);
 
 /**
  * Stampa la configurazione attuale della computazione in base agli argomenti inseriti da riga
@@ -0,0 +1,385 @@
+#include "ResultsOutput.hpp"
+#include "../strategy_cpu/SimdKernels.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <sys/utsname.h>
+#ifdef __APPLE__
+#include <sys/sysctl.h>
+#endif
+
+/**
+ * Un risultato è una lista ordinata di sezioni (run, config, env, ...), ognuna con i propri
+ * campi. In JSON ogni sezione è un oggetto annidato, in CSV ogni campo è una colonna
+ * 'sezione.campo', così i due formati hanno gli stessi dati e lo stesso ordine.
+ */
+namespace {
+
+struct Field {
+   std::string key;
+   std::string value;
+   bool is_string; // Da racchiudere fra virgolette in JSON
+};
+
+struct Section {
+   std::string name;
+   std::vector<Field> fields;
+
+   void add(const std::string &key, const std::string &value) {
+      fields.push_back({key, value, true});
+   }
+   void add(const std::string &key, const char *value) { add(key, std::string(value)); }
+   void add(const std::string &key, bool value) {
+      fields.push_back({key, value ? "true" : "false", false});
+   }
+   template <typename T> void add(const std::string &key, T value) {
+      // NaN e infiniti (es. throughput con zero task o tempo nullo) non sono JSON validi.
+      if constexpr (std::is_floating_point_v<T>) {
+         if (!std::isfinite(value)) {
+            fields.push_back({key, "null", false});
+            return;
+         }
+      }
+      std::ostringstream os;
+      os.precision(12);
+      os << value;
+      fields.push_back({key, os.str(), false});
+   }
+};
+
+} // namespace
+
+static const char *STAGE_KEYS[NUM_STAGES] = {"upload", "launch", "download"};
+static const char *DEVICE_TIME_KEYS[NUM_DEVICE_TIMES] = {"h2d", "kernel", "d2h", "queued",
+                                                         "submitted"};
+
+// Nomi dei valori delle opzioni, gli stessi accettati dalla riga di comando.
+static const char *to_string(QueueKind kind) {
+   switch (kind) {
+   case QueueKind::Spsc:
+      return "spsc";
+   case QueueKind::Mpmc:
+      return "mpmc";
+   default:
+      return "blocking";
+   }
+}
+
+static const char *to_string(WaitKind kind) {
+   switch (kind) {
+   case WaitKind::BusySpin:
+      return "spin";
+   case WaitKind::SpinYield:
+      return "yield";
+   default:
+      return "park";
+   }
+}
+
+static const char *to_string(CompletionMode mode) {
+   return mode == CompletionMode::Callback ? "callback" : "blocking";
+}
+
+static const char *to_string(FarmMode mode) {
+   return mode == FarmMode::Queue ? "queue" : "device";
+}
+
+static const char *to_string(OpenClDeviceKind kind) {
+   switch (kind) {
+   case OpenClDeviceKind::Cpu:
+      return "cpu";
+   case OpenClDeviceKind::Accelerator:
+      return "accelerator";
+   case OpenClDeviceKind::All:
+      return "all";
+   default:
+      return "gpu";
+   }
+}
+
+static const char *to_string(ClQueueMode mode) {
+   switch (mode) {
+   case ClQueueMode::OutOfOrder:
+      return "out_of_order";
+   case ClQueueMode::Split:
+      return "split";
+   default:
+      return "in_order";
+   }
+}
+
+static const char *to_string(MemMode mode) {
+   switch (mode) {
+   case MemMode::Pinned:
+      return "pinned";
+   case MemMode::ZeroCopy:
+      return "zero_copy";
+   default:
+      return "copy";
+   }
+}
+
+static const char *to_string(SourceMode mode) {
+   return mode == SourceMode::Prefetch ? "prefetch" : "mmap";
+}
+
+/**
+ * Helper interno per il modello della CPU dell'host, "unknown" se non disponibile.
+ */
+static std::string cpu_model() {
+#ifdef __APPLE__
+   char brand[256] = {0};
+   size_t size = sizeof(brand);
+   if (sysctlbyname("machdep.cpu.brand_string", brand, &size, NULL, 0) == 0)
+      return brand;
+#else
+   std::ifstream cpuinfo("/proc/cpuinfo");
+   std::string line;
+   while (std::getline(cpuinfo, line))
+      if (line.rfind("model name", 0) == 0) {
+         size_t colon = line.find(':');
+         if (colon != std::string::npos && colon + 2 <= line.size())
+            return line.substr(colon + 2);
+      }
+#endif
+   return "unknown";
+}
+
+/**
+ * Helper interno per l'istante attuale in formato ISO 8601 (UTC).
+ */
+static std::string utc_timestamp() {
+   std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+   std::tm utc{};
+   gmtime_r(&now, &utc);
+   char buffer[32];
+   std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+   return buffer;
+}
+
+static void add_latency(Section &section, const std::string &name,
+                        const LatencyPercentiles &latency) {
+   section.add(name + "_count", latency.count);
+   section.add(name + "_p50_ns", latency.p50_ns);
+   section.add(name + "_p90_ns", latency.p90_ns);
+   section.add(name + "_p99_ns", latency.p99_ns);
+   section.add(name + "_p999_ns", latency.p999_ns);
+   section.add(name + "_max_ns", latency.max_ns);
+}
+
+/**
+ * Helper interno che raccoglie tutti i campi del risultato, nell'ordine di output.
+ */
+static std::vector<Section> collect_sections(size_t N, size_t NUM_TASKS,
+                                             const std::string &device_type,
+                                             const std::string &kernel_path,
+                                             const std::string &kernel_name,
+                                             const RunConfig &config,
+                                             const ComputeResult &results,
+                                             const PerformanceData &metrics) {
+   Section run{"run", {}};
+   run.add("status", results.tasks_completed == NUM_TASKS ? "SUCCESS" : "FAILURE");
+   run.add("n", N);
+   run.add("num_tasks", NUM_TASKS);
+   run.add("device", device_type);
+   run.add("kernel", kernel_name);
+   run.add("kernel_path", kernel_path);
+
+   Section cfg{"config", {}};
+   cfg.add("queue", to_string(config.queue_kind));
+   cfg.add("wait", to_string(config.wait_kind));
+   cfg.add("queue_capacity", config.queue_capacity);
+   cfg.add("acc_stages", config.acc_stages);
+   cfg.add("pipeline_depth", config.pipeline_depth);
+   cfg.add("completion", to_string(config.completion));
+   cfg.add("acc_workers", config.acc_workers);
+   cfg.add("farm_mode", to_string(config.farm_mode));
+   cfg.add("cl_device_type", to_string(config.cl_device_kind));
+   cfg.add("cpu_workers", config.cpu_workers);
+   cfg.add("cpu_threads", config.cpu_threads);
+   cfg.add("simd", simd_name(config.simd));
+   cfg.add("farm_inflight", config.acc_max_in_flight);
+   cfg.add("chunk_size", config.chunk_size);
+   cfg.add("cl_queue", to_string(config.cl_queue_mode));
+   cfg.add("mem", to_string(config.mem_mode));
+   cfg.add("profile", config.profile);
+   cfg.add("pool", config.pool_size);
+   cfg.add("mem_budget_mb", config.mem_budget_mb);
+   cfg.add("mixed_n", config.mixed_n);
+   cfg.add("batch", config.batch_size);
+   cfg.add("batch_auto", config.batch_auto);
+   cfg.add("batch_timeout_us", config.batch_timeout_us);
+   cfg.add("warmup", config.warmup_tasks);
+   cfg.add("task_pool", config.task_pool);
+   cfg.add("task_pool_slots", config.task_pool_slots);
+   cfg.add("source", config.source_path);
+   cfg.add("source_mode", to_string(config.source_mode));
+   cfg.add("read_ahead", config.read_ahead);
+   cfg.add("sink", config.sink_path);
+   cfg.add("trace", config.trace_path);
+   cfg.add("kernel_cache", config.kernel_cache_dir);
+
+   Section env{"env", {}};
+   struct utsname host {};
+   uname(&host);
+   env.add("timestamp", utc_timestamp());
+   env.add("os", std::string(host.sysname) + " " + host.release);
+   env.add("host", std::string(host.nodename));
+   env.add("cpu_model", cpu_model());
+   env.add("hw_threads", std::thread::hardware_concurrency());
+   env.add("simd", simd_name(detect_simd()));
+   env.add("devices", results.device_names);
+
+   Section res{"result", {}};
+   res.add("tasks_completed", results.tasks_completed);
+   res.add("elapsed_ns", results.elapsed_ns);
+   res.add("computed_ns", results.computed_ns);
+   res.add("in_node_ns", results.total_InNode_time_ns);
+   res.add("inter_completion_ns", results.inter_completion_time_ns);
+   for (size_t s = 0; s < NUM_STAGES; ++s)
+      res.add(std::string("stage_busy_ns_") + STAGE_KEYS[s], results.stage_busy_ns[s]);
+   for (size_t s = 0; s < NUM_STAGES; ++s)
+      res.add(std::string("stage_wait_ns_") + STAGE_KEYS[s], results.stage_wait_ns[s]);
+   res.add("buffer_wait_ns", results.buffer_wait_ns);
+   res.add("buffer_sets_peak", results.buffer_sets_peak);
+   res.add("buffer_sets_final", results.buffer_sets_final);
+   res.add("profiled_launches", results.profiled_launches);
+   for (size_t t = 0; t < NUM_DEVICE_TIMES; ++t)
+      res.add(std::string("device_ns_") + DEVICE_TIME_KEYS[t], results.device_ns[t]);
+   res.add("startup_ns", results.startup_ns);
+   res.add("warmup_ns", results.warmup_ns);
+   res.add("first_task_ns", results.first_task_ns);
+   res.add("program_build_ns", results.program_build_ns);
+   res.add("programs_cached", results.programs_cached);
+   res.add("programs_compiled", results.programs_compiled);
+
+   Section perf{"metrics", {}};
+   perf.add("avg_service_time_ms", metrics.avg_service_time_ms);
+   perf.add("avg_in_node_time_ms", metrics.avg_InNode_time_ms);
+   perf.add("avg_compute_time_ms", metrics.avg_computed_ms);
+   perf.add("avg_overhead_time_ms", metrics.avg_overhead_ms);
+   perf.add("throughput_tasks_s", metrics.throughput);
+   perf.add("total_time_s", metrics.elapsed_s);
+   perf.add("startup_ms", metrics.startup_ms);
+   perf.add("warmup_ms", metrics.warmup_ms);
+   perf.add("first_task_ms", metrics.first_task_ms);
+   for (size_t s = 0; s < NUM_STAGES; ++s)
+      perf.add(std::string("stage_occupancy_") + STAGE_KEYS[s], metrics.stage_occupancy[s]);
+   for (size_t s = 0; s < NUM_STAGES; ++s)
+      perf.add(std::string("stage_avg_busy_ms_") + STAGE_KEYS[s],
+               metrics.stage_avg_busy_ms[s]);
+   perf.add("avg_buffer_wait_ms", metrics.avg_buffer_wait_ms);
+   for (size_t t = 0; t < NUM_DEVICE_TIMES; ++t)
+      perf.add(std::string("avg_device_ms_") + DEVICE_TIME_KEYS[t], metrics.avg_device_ms[t]);
+
+   Section latency{"latency", {}};
+   add_latency(latency, "in_node", results.in_node_latency);
+   add_latency(latency, "compute", results.computed_latency);
+   add_latency(latency, "inter_completion", results.inter_completion_latency);
+
+   return {run, cfg, env, res, perf, latency};
+}
+
+/**
+ * Helper interno per l'escape di una stringa JSON.
+ */
+static std::string json_string(const std::string &value) {
+   std::string out = "\"";
+   for (char c : value) {
+      if (c == '"' || c == '\\')
+         out += std::string("\\") + c;
+      else if (static_cast<unsigned char>(c) < 0x20) {
+         char code[8];
+         std::snprintf(code, sizeof(code), "\\u%04x", c);
+         out += code;
+      } else
+         out += c;
+   }
+   return out + "\"";
+}
+
+/**
+ * Helper interno per l'escape di un campo CSV: fra virgolette se contiene separatori,
+ * virgolette o a capo.
+ */
+static std::string csv_field(const std::string &value) {
+   if (value.find_first_of(",\"\n\r") == std::string::npos)
+      return value;
+   std::string out = "\"";
+   for (char c : value)
+      out += (c == '"') ? std::string("\"\"") : std::string(1, c);
+   return out + "\"";
+}
+
+static void write_json(std::ostream &out, const std::vector<Section> &sections) {
+   out << "{";
+   for (size_t s = 0; s < sections.size(); ++s) {
+      out << (s ? "," : "") << json_string(sections[s].name) << ":{";
+      const auto &fields = sections[s].fields;
+      for (size_t f = 0; f < fields.size(); ++f)
+         out << (f ? "," : "") << json_string(fields[f].key) << ":"
+             << (fields[f].is_string ? json_string(fields[f].value) : fields[f].value);
+      out << "}";
+   }
+   out << "}\n";
+}
+
+static void write_csv(std::ostream &out, const std::vector<Section> &sections,
+                      bool with_header) {
+   std::string header, row;
+   for (const auto &section : sections)
+      for (const auto &field : section.fields) {
+         const char *sep = header.empty() ? "" : ",";
+         header += sep + section.name + "." + field.key;
+         row += sep + csv_field(field.value);
+      }
+   if (with_header)
+      out << header << "\n";
+   out << row << "\n";
+}
+
+void write_results(size_t N, size_t NUM_TASKS, const std::string &device_type,
+                   const std::string &kernel_path, const std::string &kernel_name,
+                   const RunConfig &config, const ComputeResult &results,
+                   const PerformanceData &metrics) {
+   std::vector<Section> sections = collect_sections(N, NUM_TASKS, device_type, kernel_path,
+                                                    kernel_name, config, results, metrics);
+   const bool csv = config.output_format == OutputFormat::Csv;
+
+   if (config.output_path.empty()) {
+      if (csv)
+         write_csv(std::cout, sections, true);
+      else
+         write_json(std::cout, sections);
+      return;
+   }
+
+   // L'intestazione CSV va scritta solo se il file è nuovo o vuoto.
+   bool empty_file;
+   {
+      std::ifstream existing(config.output_path, std::ios::ate);
+      empty_file = !existing || existing.tellg() <= 0;
+   }
+
+   std::ofstream out(config.output_path, std::ios::app);
+   if (!out) {
+      std::cerr << "[ERROR] Cannot open results file '" << config.output_path << "'.\n";
+      exit(EXIT_FAILURE);
+   }
+   if (csv)
+      write_csv(out, sections, empty_file);
+   else
+      write_json(out, sections);
+   std::cout << "[Main] Results appended to '" << config.output_path << "'.\n";
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../common/ComputeResult.hpp"
+#include "../common/PerformanceData.hpp"
+#include "../common/RunConfig.hpp"
+#include <cstddef>
+#include <string>
+
+/**
+ * Scrive i risultati in formato strutturato (RunConfig::output_format = Json o Csv): tutti i
+ * campi di ComputeResult e PerformanceData, la configurazione completa e l'ambiente di
+ * esecuzione (CPU, thread hardware, dispositivi). Con RunConfig::output_path i risultati
+ * vengono aggiunti al file (con l'intestazione CSV se il file è vuoto), altrimenti stampati su
+ * stdout.
+ */
+void write_results(size_t N, size_t NUM_TASKS, const std::string &device_type,
+                   const std::string &kernel_path, const std::string &kernel_name,
+                   const RunConfig &config, const ComputeResult &results,
+                   const PerformanceData &metrics);
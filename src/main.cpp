@@ -12,8 +12,10 @@
 
 #include "common/ComputeResult.hpp"
 #include "common/IDeviceRunner.hpp"
+#include "common/Tracer.hpp"
 #include "factory/DeviceRunner_Factory.hpp"
 #include "helpers/Helpers.hpp"
+#include "helpers/ResultsOutput.hpp"
 
 #include <iostream>
 #include <memory>
@@ -23,17 +25,30 @@ int main(int argc, char *argv[]) {
    // Parametri inseriti da command line.
    size_t N, NUM_TASKS;
    std::string device_type, kernel_path, kernel_name;
+   RunConfig config;
+
+   parse_args(argc, argv, N, NUM_TASKS, device_type, kernel_path, kernel_name, config);
+
+   // Con i risultati strutturati su stdout, tutte le altre stampe (configurazione, runner,
+   // factory, tracer) vanno su stderr: stdout contiene solo il record JSON o CSV.
+   const bool structured = config.output_format != OutputFormat::Text;
+   std::streambuf *stdout_buf = std::cout.rdbuf();
+   if (structured && config.output_path.empty())
+      std::cout.rdbuf(std::cerr.rdbuf());
 
-   parse_args(argc, argv, N, NUM_TASKS, device_type, kernel_path, kernel_name);
    print_configuration(N, NUM_TASKS, device_type, kernel_path, kernel_name);
 
+   // Il tracciamento va attivato prima che i runner avviino i loro thread.
+   if (!config.trace_path.empty())
+      Tracer::start(config.trace_path);
+
    ComputeResult results;
 
    try {
       // Delega alla Factory la creazione della strategia di esecuzione corretta
       // (tramite Cpu_OMP_Runner, AcceleratorPipelineRunner, ecc.) in base al device_type.
       std::unique_ptr<IDeviceRunner> strategy =
-         create_runner_for_device(device_type, kernel_path, kernel_name);
+         create_runner_for_device(device_type, kernel_path, kernel_name, config);
 
       // Esecuzione della computazione tramite la Strategy scelta che esegue la
       // parallelizzazione dei task su CPU multicore o tramite la pipeline con offloading su GPU/FPGA.
@@ -46,7 +61,15 @@ int main(int argc, char *argv[]) {
    }
 
    PerformanceData metrics = calculate_metrics(results);
-   print_metrics(N, NUM_TASKS, device_type, kernel_name, metrics, results.tasks_completed);
+
+   // Le metriche leggibili vengono stampate, a meno che stdout non sia riservato ai risultati
+   // strutturati.
+   if (!structured || !config.output_path.empty())
+      print_metrics(N, NUM_TASKS, device_type, kernel_name, metrics, results.tasks_completed);
+   std::cout.rdbuf(stdout_buf);
+   if (structured)
+      write_results(N, NUM_TASKS, device_type, kernel_path, kernel_name, config, results,
+                    metrics);
 
    return 0;
 }
\ No newline at end of file
@@ -2,34 +2,112 @@
 
 #include "../../include/ff_includes.hpp"
 #include "../common/StatsCollector.hpp"
-#include "../ff_Pipe_nodes/Emitter.hpp"
+#include "../common/Tracer.hpp"
+#include "../ff_Pipe_nodes/FileSink.hpp"
+#include "../ff_Pipe_nodes/FileSource.hpp"
+#include "../ff_Pipe_nodes/InFlightScheduler.hpp"
+#include "../ff_Pipe_nodes/TaskBatcher.hpp"
 #include "../ff_Pipe_nodes/ff_node_acc_t.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <iostream>
+#include <stdexcept>
 
 /**
  * @brief Costruttore. Prende possesso del puntatore all'acceleratore.
  */
-AcceleratorPipelineRunner::AcceleratorPipelineRunner(std::unique_ptr<IAccelerator> accelerator)
-    : accelerator_(std::move(accelerator)) {}
+AcceleratorPipelineRunner::AcceleratorPipelineRunner(std::unique_ptr<IAccelerator> accelerator,
+                                                     const RunConfig &config)
+    : config_(config) {
+   accelerators_.push_back(std::move(accelerator));
+}
+
+/**
+ * @brief Costruttore per la farm. Prende possesso di tutti gli acceleratori, uno per worker.
+ */
+AcceleratorPipelineRunner::AcceleratorPipelineRunner(
+   std::vector<std::unique_ptr<IAccelerator>> accelerators, const RunConfig &config)
+    : accelerators_(std::move(accelerators)), config_(config) {}
 
 /**
  * @brief Orchestra l'intera pipeline FastFlow per l'offloading su un acceleratore. Crea i due
- * nodi della pipeline FF (Emitter, ff_node_acc_t). Riceve l'acceleratore già inizializzato.
- * Avvia la pipeline. Raccoglie e misura i tempi di esecuzione e il numero di task completati.
+ * nodi della pipeline FF (Emitter, ff_node_acc_t). Inizializza gli acceleratori ed esegue i
+ * task di warm-up prima di avviare la misura. Avvia la pipeline. Raccoglie e misura i tempi
+ * di esecuzione e il numero di task completati.
  */
 ComputeResult AcceleratorPipelineRunner::execute(size_t N, size_t NUM_TASKS) {
-   // Dati per ottenere il conteggio finale dei task processati.
+   const size_t num_workers = accelerators_.size();
+
+   // Dati per ottenere il conteggio finale dei task processati, condivisi da tutti i nodi
+   // ff_node_acc_t: il conteggio arriva quando l'ultimo dei loro Consumer termina.
    StatsCollector stats;
+   stats.active_consumers = num_workers;
    std::future<size_t> count_future = stats.count_promise.get_future();
 
-   // Creazione della pipeline FF e dei suoi due nodi (Emitter, ff_node_acc_t),
-   // il cui secondo nodo incapsula una pipeline interna a 2 thread (producer, consumer).
-   Emitter emitter(N, NUM_TASKS);
-   ff_node_acc_t accNode(accelerator_.get(), &stats);
-   ff_Pipe<> pipe(&emitter, &accNode);
+   const bool sink = !config_.sink_path.empty();
+
+   // Creazione della pipeline FF e dei suoi due nodi (sorgente, ff_node_acc_t), il cui
+   // secondo nodo incapsula una pipeline interna a 2 thread (producer, consumer). La sorgente
+   // è l'Emitter o, con --source, il FileSource. Con più acceleratori il secondo nodo è una
+   // farm di ff_node_acc_t, con il batching fra i due nodi c'è il TaskBatcher e con --sink
+   // dopo ff_node_acc_t (o dopo il collector della farm) c'è il FileSink, a cui i nodi
+   // inviano i task completati.
+   const bool batching = config_.batch_size > 1 || config_.batch_auto;
+   // Il pool di task deve contenere almeno due batch dei task più piccoli (con --batch=auto
+   // sono i batch più numerosi), e il batcher ricicla tanti batch quanti ne stanno nel pool.
+   size_t min_n = std::max<size_t>(N >> (config_.mixed_n - 1), 1);
+   size_t batch_tasks = !batching          ? 1
+                        : config_.batch_auto ? TaskBatcher::auto_batch_size(min_n)
+                                             : config_.batch_size;
+   size_t task_slots = TaskPool::slots_for(config_, N, NUM_TASKS, batch_tasks);
+   TaskBatcher batcher(config_.batch_size, config_.batch_auto, config_.batch_timeout_us,
+                       batching ? TaskBatcher::batch_slots_for(task_slots, batch_tasks) : 0);
+   std::unique_ptr<ff_node> source = make_source_node(config_, N, NUM_TASKS, batch_tasks);
+   std::unique_ptr<FileSink> file_sink;
+   if (sink)
+      file_sink = std::make_unique<FileSink>(config_.sink_path, N);
+
+   std::vector<WorkerLoad> loads(num_workers);
+   std::vector<std::unique_ptr<ff_node_acc_t>> accNodes;
+   for (size_t w = 0; w < num_workers; ++w) {
+      accNodes.push_back(std::make_unique<ff_node_acc_t>(
+         accelerators_[w].get(), &stats, config_, num_workers > 1 ? &loads[w] : nullptr));
+      accNodes.back()->set_forward_output(sink);
+   }
+
+   InFlightScheduler scheduler(loads);
+   ff_farm farm;
+   ff_Pipe<> pipe(source.get());
+   if (batching)
+      pipe.add_stage(&batcher);
+
+   if (num_workers == 1)
+      pipe.add_stage(accNodes[0].get());
+   else {
+      std::vector<ff_node *> workers;
+      for (auto &node : accNodes)
+         workers.push_back(node.get());
+      farm.add_emitter(&scheduler);
+      farm.add_workers(workers);
+      if (!sink)
+         farm.remove_collector(); // I worker sono nodi terminali
+      pipe.add_stage(&farm);
+
+      std::cout << "[Main] Accelerator farm with " << num_workers << " workers.\n";
+   }
+   if (sink)
+      pipe.add_stage(file_sink.get());
+
+   // Inizializzazione e warm-up degli acceleratori, fuori dal tempo misurato.
+   std::vector<ff_node_acc_t *> prepare_nodes;
+   for (auto &node : accNodes)
+      prepare_nodes.push_back(node.get());
+   if (!ff_node_acc_t::prepare_all(prepare_nodes)) {
+      std::cerr << "[ERROR] Main: Accelerator initialization failed.\n";
+      exit(EXIT_FAILURE);
+   }
 
    std::cout << "[Main] Starting FF pipeline execution...\n";
    auto t0 = std::chrono::steady_clock::now();
@@ -43,13 +121,22 @@ ComputeResult AcceleratorPipelineRunner::execute(size_t N, size_t NUM_TASKS) {
    auto t1 = std::chrono::steady_clock::now();
    std::cout << "[Main] FF Pipeline execution finished.\n";
 
+   if (num_workers > 1)
+      for (size_t w = 0; w < num_workers; ++w)
+         std::cout << "[Main] Worker " << w << " completed " << loads[w].completed.load()
+                   << " tasks.\n";
+
    // Raccolta dei risultati.
    ComputeResult res;
    res.tasks_completed = count_future.get();
    res.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
-   res.computed_ns = stats.computed_ns.load();
-   res.total_InNode_time_ns = stats.total_InNode_time_ns.load();
-   res.inter_completion_time_ns = stats.inter_completion_time_ns.load();
+   stats.fill_result(res);
+   res.first_task_ns = stats.first_task_ns(t0);
+   res.warmup_tasks = config_.warmup_tasks;
+   for (auto &accelerator : accelerators_)
+      accelerator->report_stats(res);
 
+   // I thread della pipeline sono terminati: i buffer della traccia possono essere letti.
+   Tracer::dump();
    return res;
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../common/IDeviceRunner.hpp"
+#include "../common/RunConfig.hpp"
 #include "./accelerator/IAccelerator.hpp"
 #include <memory>
+#include <vector>
 
 /**
  * @brief Strategia concreta che implementa IDeviceRunner (è anche un Adapter).
@@ -10,13 +12,23 @@
  * Questa classe "adatta" la logica della pipeline FastFlow + Acceleratore per farla apparire
  * come una semplice strategia eseguibile dal main.
  *
+ * Con più acceleratori la pipeline diventa Emitter -> farm, con un nodo ff_node_acc_t per
+ * acceleratore e uno scheduler che assegna ogni task al worker con meno task in volo.
  */
 class AcceleratorPipelineRunner : public IDeviceRunner {
  public:
    /**
     * @brief Costruttore che prende possesso dell'acceleratore hardware da usare.
+    * @param config Opzioni di esecuzione inoltrate al nodo ff_node_acc_t.
     */
-   explicit AcceleratorPipelineRunner(std::unique_ptr<IAccelerator> accelerator);
+   explicit AcceleratorPipelineRunner(std::unique_ptr<IAccelerator> accelerator,
+                                      const RunConfig &config = RunConfig());
+
+   /**
+    * @brief Costruttore per la farm: prende possesso di un acceleratore per ogni worker.
+    */
+   explicit AcceleratorPipelineRunner(std::vector<std::unique_ptr<IAccelerator>> accelerators,
+                                      const RunConfig &config = RunConfig());
 
    virtual ~AcceleratorPipelineRunner() = default;
 
@@ -29,5 +41,6 @@ class AcceleratorPipelineRunner : public IDeviceRunner {
    ComputeResult execute(size_t N, size_t NUM_TASKS) override;
 
  private:
-   std::unique_ptr<IAccelerator> accelerator_;
+   std::vector<std::unique_ptr<IAccelerator>> accelerators_;
+   RunConfig config_;
 };
\ No newline at end of file
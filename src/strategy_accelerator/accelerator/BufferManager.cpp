@@ -1,110 +1,546 @@
 #include "BufferManager.hpp"
+#include "Profiling.hpp"
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+
+// Vettore allineato alla pagina (HostVector, slab del TaskPool): può essere fissato in memoria
+// con CL_MEM_USE_HOST_PTR senza copie interne del runtime.
+static bool page_aligned(const int *ptr) {
+   return reinterpret_cast<std::uintptr_t>(ptr) % 4096 == 0;
+}
 
 /**
- * @brief Costruttore: inizializza il pool di buffer.
+ * @brief Costruttore: legge la memoria del device, fissa il budget del pool e alloca i set
+ * delle dimensioni attese (N dei task e, con mixed_n, le sue metà). La coda 'map_queue' serve
+ * solo con la modalità Pinned, per mappare i vettori dei task fissati in memoria.
+ * 'budget_share' è il numero di pool che si dividono la memoria del device (worker della farm
+ * sullo stesso device).
  */
-BufferManager::BufferManager(cl_context context) : context_(context) {
-   buffer_pool_.resize(POOL_SIZE);
-   for (size_t i = 0; i < POOL_SIZE; ++i)
-      free_buffer_indices_.push(i);
+BufferManager::BufferManager(cl_context context, cl_device_id device,
+                             cl_command_queue map_queue, const RunConfig &config,
+                             size_t budget_share)
+    : context_(context), map_queue_(map_queue), mode_(config.mem_mode),
+      adaptive_(config.pool_size == 0) {
+   cl_ulong global_mem = 0, max_alloc = 0;
+   clGetDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(global_mem), &global_mem, NULL);
+   clGetDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(max_alloc), &max_alloc, NULL);
+   max_alloc_bytes_ = static_cast<size_t>(max_alloc);
+   memory_budget_bytes_ = (config.mem_budget_mb > 0) ? config.mem_budget_mb << 20
+                                                     : static_cast<size_t>(global_mem / 4 * 3);
+   memory_budget_bytes_ /= std::max<size_t>(budget_share, 1);
+
+   initial_sets_ = adaptive_ ? config.acc_stages + 1 : config.pool_size;
+
+   buffer_pool_.resize(MAX_POOL_SIZE);
+   for (size_t i = MAX_POOL_SIZE; i > 0; --i)
+      unused_slots_.push_back(i - 1);
+
+   // Preallocazione delle classi attese, un set per classe alla volta così, se il budget non
+   // basta, ogni classe ne ha almeno uno.
+   std::vector<size_t> expected_classes;
+   for (size_t level = 0; level < config.mixed_n && config.expected_n >> level > 0; ++level) {
+      size_t bytes = sizeof(int) * (config.expected_n >> level);
+      if (max_alloc_bytes_ == 0 || bytes <= max_alloc_bytes_)
+         expected_classes.push_back(class_of(bytes));
+   }
+   for (size_t round = 0; round < initial_sets_; ++round)
+      for (size_t size_class : expected_classes)
+         if (classes_[size_class].active == round)
+            grow_class(size_class, false);
+
+   size_t total_sets = MAX_POOL_SIZE - unused_slots_.size();
+   std::cerr << "[BufferManager] Pool: " << total_sets << " sets preallocated ("
+             << (pool_bytes_ >> 20) << " MB)" << (adaptive_ ? ", adaptive" : "")
+             << ", memory budget " << (memory_budget_bytes_ >> 20) << " MB.\n";
 }
 
 /**
  * @brief Distruttore: rilascia tutti i buffer di memoria nel pool.
  */
 BufferManager::~BufferManager() {
-   for (auto &buffer_set : buffer_pool_) {
-      if (buffer_set.bufferA) {
-         clReleaseMemObject(buffer_set.bufferA);
-         buffer_set.bufferA = nullptr;
-      }
-      if (buffer_set.bufferB) {
-         clReleaseMemObject(buffer_set.bufferB);
-         buffer_set.bufferB = nullptr;
-      }
-      if (buffer_set.bufferC) {
-         clReleaseMemObject(buffer_set.bufferC);
-         buffer_set.bufferC = nullptr;
-      }
+   for (auto &buffer_set : buffer_pool_)
+      release_set(buffer_set);
+   drop_free_bindings();
+}
 
-      if (buffer_set.bufferA != nullptr && buffer_set.bufferB != nullptr &&
-          buffer_set.bufferC != nullptr)
-         std::cerr << "[BufferManager] Warning: Some buffers were not released properly.\n";
+/**
+ * @brief Rilascia i buffer di un set. Con ZeroCopy i buffer appartengono al binding, che resta
+ * nella cache (come quello di Pinned).
+ */
+void BufferManager::release_set(BufferSet &buffer_set) {
+   cl_mem *buffers[] = {&buffer_set.bufferA, &buffer_set.bufferB, &buffer_set.bufferC};
+   for (cl_mem *buffer : buffers) {
+      if (*buffer && mode_ != MemMode::ZeroCopy)
+         clReleaseMemObject(*buffer);
+      *buffer = nullptr;
    }
+   if (buffer_set.binding)
+      buffer_set.binding->in_use = false;
+   buffer_set.binding = nullptr;
 }
 
 /**
- * @brief Acquisisce un indice di buffer dal pool. Se nessun buffer è
- * disponibile per un thread da acquisire, attende in modo non bloccante.
+ * @brief Classe di dimensione per 'bytes' byte: il minimo k >= MIN_CLASS con 2^k >= bytes.
  */
-size_t BufferManager::acquire_buffer_set() {
+size_t BufferManager::class_of(size_t bytes) const {
+   size_t size_class = MIN_CLASS;
+   while (size_class + 1 < NUM_CLASSES && (size_t(1) << size_class) < bytes)
+      ++size_class;
+   return size_class;
+}
+
+/**
+ * @brief Byte dei buffer di un set della classe: 2^k, limitato dalla dimensione massima di
+ * un'allocazione sul device.
+ */
+size_t BufferManager::class_capacity(size_t size_class) const {
+   size_t capacity = size_t(1) << size_class;
+   if (max_alloc_bytes_ > 0 && capacity > max_alloc_bytes_)
+      capacity = max_alloc_bytes_;
+   return capacity;
+}
+
+/**
+ * @brief Memoria del device allocata da un set della classe: i tre buffer, o nulla con
+ * ZeroCopy, i cui buffer vengono creati sui vettori dei task (vedi bind_host_memory).
+ */
+size_t BufferManager::set_device_bytes(size_t size_class) const {
+   return mode_ == MemMode::ZeroCopy ? 0 : 3 * class_capacity(size_class);
+}
+
+/**
+ * @brief Acquisisce un set della classe di 'required_size_bytes' dal pool. Se la classe non ha
+ * ancora set li alloca; se nessun set della classe è libero attende in modo non bloccante.
+ * In modalità auto misura l'attesa per adattare la dimensione del pool.
+ */
+size_t BufferManager::acquire_buffer_set(size_t required_size_bytes) {
+   if (max_alloc_bytes_ > 0 && required_size_bytes > max_alloc_bytes_) {
+      std::cerr << "[FATAL] BufferManager: Buffer of " << required_size_bytes
+                << " bytes exceeds CL_DEVICE_MAX_MEM_ALLOC_SIZE (" << max_alloc_bytes_
+                << " bytes).\n";
+      exit(EXIT_FAILURE);
+   }
+
+   auto t0 = std::chrono::steady_clock::now();
+   size_t size_class = class_of(required_size_bytes);
+   SizeClass &sc = classes_[size_class];
+   if (memory_budget_bytes_ > 0 && set_device_bytes(size_class) > memory_budget_bytes_) {
+      std::cerr << "[FATAL] BufferManager: A buffer set of " << class_capacity(size_class)
+                << " bytes per buffer exceeds the memory budget (" << memory_budget_bytes_
+                << " bytes).\n";
+      exit(EXIT_FAILURE);
+   }
    std::unique_lock<std::mutex> lock(pool_mutex_);
 
-   // Attende finché non c'è un buffer libero.
-   buffer_available_cond_.wait(lock, [this] { return !free_buffer_indices_.empty(); });
+   // Prima richiesta di una dimensione non prevista: alloca i set della classe.
+   if (sc.active == 0) {
+      if (!sc.used)
+         std::cerr << "  [BufferManager - DEBUG] Allocating size class of "
+                   << class_capacity(size_class) << " bytes\n";
+      for (size_t i = 0; i < initial_sets_; ++i)
+         if (!grow_class(size_class, i == 0))
+            break;
+   }
+
+   // Attende finché non c'è un set libero della classe. Se la classe è rimasta senza set
+   // (budget esaurito) riprova a ogni rilascio, liberando set liberi di altre classi.
+   buffer_available_cond_.wait(lock, [&] {
+      return !sc.free.empty() || (sc.active == 0 && grow_class(size_class, true));
+   });
+
+   // Thread risvegliato. Estrae e restituisce l'indice del set libero.
+   size_t index = sc.free.front();
+   sc.free.pop();
 
-   // Thread risvegliato. Estrae e restituisce l'indice del buffer libero.
-   size_t index = free_buffer_indices_.front();
-   free_buffer_indices_.pop();
+   peak_in_use_ = std::max(peak_in_use_, ++in_use_);
+   if (adaptive_) {
+      long long wait_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - t0)
+                             .count();
+      adapt_pool(size_class, t0, wait_ns);
+   }
    return index;
 }
 
 /**
- * @brief Rilascia un indice di buffer nel pool e notifica i thread in attesa.
+ * @brief Rilascia un set nella lista libera della sua classe e notifica i thread in attesa.
+ * Se la classe deve rimpicciolirsi il set viene invece tolto dal pool e la sua memoria
+ * liberata.
  */
 void BufferManager::release_buffer_set(size_t index) {
    {
       std::lock_guard<std::mutex> lock(pool_mutex_);
-      free_buffer_indices_.push(index);
+      SizeClass &sc = classes_[buffer_pool_[index].size_class];
+      if (buffer_pool_[index].binding)
+         buffer_pool_[index].binding->in_use = false;
+      --in_use_;
+      if (sc.retire_pending > 0 && sc.active > 1) {
+         --sc.retire_pending;
+         retire_slot(index);
+      } else {
+         sc.free.push(index);
+      }
    }
-   buffer_available_cond_.notify_one();
+   buffer_available_cond_.notify_all();
 }
 
 /**
- * @brief Helper per allocare o riallocare la memoria per tutti i buffer del
- * pool. Viene invocata al primo utilizzo o quando un task richiede una
- * dimensione di dati differente da quella corrente.
+ * @brief Chiude una finestra di ADAPT_WINDOW acquisizioni. Se l'attesa dei set liberi supera
+ * 1/4 della finestra aggiunge un set alla classe che ha atteso; dopo una finestra di
+ * transizione confronta il throughput con quello precedente alla crescita e, se non è
+ * migliorato almeno del 5%, toglie il set e il pool smette di crescere.
  */
-bool BufferManager::reallocate_buffers_if_needed(size_t required_size_bytes) {
-   if (allocated_size_bytes_ == required_size_bytes)
-      return true; // Nessuna riallocazione necessaria
+void BufferManager::adapt_pool(size_t size_class, std::chrono::steady_clock::time_point start,
+                               long long wait_ns) {
+   if (window_acquires_ == 0)
+      window_start_ = start;
+   window_wait_ns_ += wait_ns;
+   if (++window_acquires_ < ADAPT_WINDOW)
+      return;
 
-   std::cerr << "  [BufferManager - DEBUG] Allocating pool buffers for " << required_size_bytes
-             << " bytes\n";
+   long long window_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - window_start_)
+                            .count();
+   double rate = (window_ns > 0) ? ADAPT_WINDOW * 1.0e9 / window_ns : 0.0;
 
-   // Rilascia eventuali buffer esistenti.
-   for (auto &buffer_set : buffer_pool_) {
-      if (buffer_set.bufferA)
-         clReleaseMemObject(buffer_set.bufferA);
-      if (buffer_set.bufferB)
-         clReleaseMemObject(buffer_set.bufferB);
-      if (buffer_set.bufferC)
-         clReleaseMemObject(buffer_set.bufferC);
+   if (settle_windows_ > 0) {
+      --settle_windows_; // Finestra di transizione dopo una crescita: non misura nulla
+   } else if (grew_last_) {
+      grew_last_ = false;
+      if (rate < last_rate_ * 1.05) {
+         converged_ = true;
+         shrink_class(grown_class_);
+      }
+      last_rate_ = rate;
+   } else {
+      if (!converged_ && window_wait_ns_ * 4 > window_ns && grow_class(size_class, false)) {
+         std::cerr << "[BufferManager] Pool grown to " << classes_[size_class].active
+                   << " sets of " << class_capacity(size_class) << " bytes.\n";
+         grown_class_ = size_class;
+         grew_last_ = true;
+         settle_windows_ = 1;
+      }
+      last_rate_ = rate;
    }
 
-   // Alloca nuovi buffer.
-   cl_int ret;
-   for (size_t i = 0; i < POOL_SIZE; ++i) {
-      buffer_pool_[i].bufferA =
-         clCreateBuffer(context_, CL_MEM_READ_ONLY, required_size_bytes, NULL, &ret);
-      buffer_pool_[i].bufferB =
-         clCreateBuffer(context_, CL_MEM_READ_ONLY, required_size_bytes, NULL, &ret);
-      buffer_pool_[i].bufferC =
-         clCreateBuffer(context_, CL_MEM_WRITE_ONLY, required_size_bytes, NULL, &ret);
+   window_acquires_ = 0;
+   window_wait_ns_ = 0;
+}
+
+/**
+ * @brief Aggiunge alla classe un set libero, se c'è uno slot e il budget di memoria lo
+ * consente. Con make_room, se il budget è esaurito, toglie prima dal pool set liberi di altre
+ * classi.
+ */
+bool BufferManager::grow_class(size_t size_class, bool make_room) {
+   size_t set_bytes = set_device_bytes(size_class);
+   auto fits = [&] {
+      return !unused_slots_.empty() &&
+             (memory_budget_bytes_ == 0 || pool_bytes_ + set_bytes <= memory_budget_bytes_);
+   };
+
+   for (size_t other = 0; make_room && !fits() && other < NUM_CLASSES; ++other) {
+      if (other == size_class)
+         continue;
+      while (!fits() && !classes_[other].free.empty()) {
+         size_t index = classes_[other].free.front();
+         classes_[other].free.pop();
+         retire_slot(index);
+      }
+   }
+   if (!fits())
+      return false;
+
+   size_t index = unused_slots_.back();
+   BufferSet &buffer_set = buffer_pool_[index];
+   if (!allocate_set(buffer_set, class_capacity(size_class))) {
+      release_set(buffer_set);
+      return false;
+   }
+   unused_slots_.pop_back();
+
+   buffer_set.in_pool = true;
+   buffer_set.size_class = size_class;
+   classes_[size_class].free.push(index);
+   ++classes_[size_class].active;
+   classes_[size_class].used = true;
+   pool_bytes_ += set_bytes;
+   return true;
+}
+
+/**
+ * @brief Toglie un set dalla classe: subito se ce n'è uno libero, altrimenti al prossimo
+ * rilascio.
+ */
+bool BufferManager::shrink_class(size_t size_class) {
+   SizeClass &sc = classes_[size_class];
+   if (sc.active - sc.retire_pending <= 1)
+      return false;
+
+   if (sc.free.empty()) {
+      ++sc.retire_pending;
+   } else {
+      size_t index = sc.free.front();
+      sc.free.pop();
+      retire_slot(index);
+   }
+
+   std::cerr << "[BufferManager] Pool shrunk to " << sc.active - sc.retire_pending
+             << " sets of " << class_capacity(size_class) << " bytes.\n";
+   return true;
+}
+
+/**
+ * @brief Toglie dal pool un set non in uso (già fuori dalla lista libera) e ne libera la
+ * memoria.
+ */
+void BufferManager::retire_slot(size_t index) {
+   BufferSet &buffer_set = buffer_pool_[index];
+   release_set(buffer_set);
+   buffer_set.in_pool = false;
+   --classes_[buffer_set.size_class].active;
+   pool_bytes_ -= set_device_bytes(buffer_set.size_class);
+   unused_slots_.push_back(index);
+}
+
+/**
+ * @brief Alloca i buffer di un set. Con ZeroCopy non alloca nulla: i buffer vengono creati sui
+ * vettori del primo task che usa il set.
+ */
+bool BufferManager::allocate_set(BufferSet &buffer_set, size_t bytes) {
+   if (mode_ == MemMode::ZeroCopy)
+      return true;
+
+   cl_int ret_a, ret_b, ret_c;
+   buffer_set.bufferA = clCreateBuffer(context_, CL_MEM_READ_ONLY, bytes, NULL, &ret_a);
+   buffer_set.bufferB = clCreateBuffer(context_, CL_MEM_READ_ONLY, bytes, NULL, &ret_b);
+   buffer_set.bufferC = clCreateBuffer(context_, CL_MEM_WRITE_ONLY, bytes, NULL, &ret_c);
+   if (ret_a != CL_SUCCESS || ret_b != CL_SUCCESS || ret_c != CL_SUCCESS) {
+      std::cerr
+         << "[ERROR] BufferManager: Failed to allocate buffer pool. If on FPGA, maxium N "
+            "usable is 7449999.\n";
+      return false;
+   }
+   return true;
+}
+
+/**
+ * @brief Set usati al massimo contemporaneamente e set nel pool a fine esecuzione.
+ */
+void BufferManager::report_stats(ComputeResult &res) {
+   std::lock_guard<std::mutex> lock(pool_mutex_);
+   res.buffer_sets_peak += peak_in_use_;
+   for (const SizeClass &sc : classes_)
+      res.buffer_sets_final += sc.active - sc.retire_pending;
+}
+
+/**
+ * @brief Lega il set ai buffer CL_MEM_USE_HOST_PTR dei vettori del task. Cerca prima l'ultimo
+ * binding del set (task che condividono i vettori), poi un binding libero della cache sugli
+ * stessi vettori (lo slot del TaskPool, tornato in un set qualsiasi), e solo se non c'è crea i
+ * buffer: a regime ogni slot ha il suo binding e l'upload non crea nulla. Con Pinned i buffer
+ * del binding vengono mappati una volta sola e restano mappati: i vettori restano fissati in
+ * memoria e i trasferimenti del set partono da lì.
+ */
+bool BufferManager::bind_host_memory(BufferSet &buffer_set, const int *a, const int *b, int *c,
+                                     size_t bytes) {
+   std::lock_guard<std::mutex> lock(pool_mutex_);
+   auto usable = [&](const HostBinding &binding) {
+      return !binding.in_use && binding.a == a && binding.b == b && binding.bytes >= bytes;
+   };
+
+   HostBinding *binding = nullptr;
+   if (buffer_set.binding && buffer_set.binding->c == c && usable(*buffer_set.binding))
+      binding = buffer_set.binding;
+   auto range = host_bindings_.equal_range(c);
+   for (auto it = range.first; !binding && it != range.second;) {
+      if (usable(it->second)) {
+         binding = &it->second;
+      } else if (!it->second.in_use && it->second.a == a && it->second.b == b) {
+         // Binding troppo piccolo (mixed_n): viene ricreato per la dimensione nuova.
+         it = erase_binding(it);
+         continue;
+      }
+      ++it;
+   }
+
+   if (!binding) {
+      if (host_bindings_.size() >= MAX_HOST_BINDINGS)
+         drop_free_bindings();
+
+      // Con Pinned i buffer servono solo a fissare i vettori: il kernel usa quelli del set.
+      const bool pinned = mode_ == MemMode::Pinned;
+      const cl_mem_flags in_flags = pinned ? CL_MEM_READ_WRITE : CL_MEM_READ_ONLY;
+      const cl_mem_flags out_flags = pinned ? CL_MEM_READ_WRITE : CL_MEM_WRITE_ONLY;
+      HostBinding created{a, b, c, bytes};
+      cl_int ret_a, ret_b, ret_c;
+      created.bufferA = clCreateBuffer(context_, in_flags | CL_MEM_USE_HOST_PTR, bytes,
+                                       const_cast<int *>(a), &ret_a);
+      created.bufferB = clCreateBuffer(context_, in_flags | CL_MEM_USE_HOST_PTR, bytes,
+                                       const_cast<int *>(b), &ret_b);
+      created.bufferC =
+         clCreateBuffer(context_, out_flags | CL_MEM_USE_HOST_PTR, bytes, c, &ret_c);
+      cl_int ret = (ret_a != CL_SUCCESS) ? ret_a : (ret_b != CL_SUCCESS) ? ret_b : ret_c;
+
+      // Con CL_MEM_USE_HOST_PTR la map restituisce i vettori stessi.
+      cl_mem buffers[] = {created.bufferA, created.bufferB, created.bufferC};
+      for (size_t k = 0; pinned && k < 3 && ret == CL_SUCCESS; ++k)
+         clEnqueueMapBuffer(map_queue_, buffers[k], CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0,
+                            bytes, 0, NULL, NULL, &ret);
       if (ret != CL_SUCCESS) {
-         std::cerr
-            << "[ERROR] BufferManager: Failed to allocate buffer pool. If on FPGA, maxium N "
-               "usable is 7449999.\n";
+         std::cerr << "[ERROR] BufferManager: Failed to create "
+                   << (pinned ? "pinned" : "zero-copy") << " buffers.\n";
+         if (pinned)
+            clFinish(map_queue_);
+         for (cl_mem buffer : buffers)
+            if (buffer)
+               clReleaseMemObject(buffer);
          return false;
       }
+      binding = &host_bindings_.emplace(c, created)->second;
    }
 
-   allocated_size_bytes_ = required_size_bytes;
+   binding->in_use = true;
+   buffer_set.binding = binding;
+   if (mode_ == MemMode::ZeroCopy) {
+      buffer_set.bufferA = binding->bufferA;
+      buffer_set.bufferB = binding->bufferB;
+      buffer_set.bufferC = binding->bufferC;
+   }
    return true;
 }
 
+/**
+ * @brief Rilascia i binding non legati a un set acquisito: alla distruzione e quando la cache
+ * supera MAX_HOST_BINDINGS (vettori sempre diversi, ad esempio task senza pool).
+ */
+void BufferManager::drop_free_bindings() {
+   for (auto it = host_bindings_.begin(); it != host_bindings_.end();)
+      it = it->second.in_use ? std::next(it) : erase_binding(it);
+}
+
+/**
+ * @brief Rilascia i buffer di un binding libero (con Pinned dopo averli smappati) e lo toglie
+ * dalla cache e dai set che lo ricordano come ultimo binding.
+ */
+BufferManager::HostBindings::iterator BufferManager::erase_binding(HostBindings::iterator it) {
+   for (BufferSet &buffer_set : buffer_pool_)
+      if (buffer_set.binding == &it->second) {
+         buffer_set.binding = nullptr;
+         if (mode_ == MemMode::ZeroCopy)
+            buffer_set.bufferA = buffer_set.bufferB = buffer_set.bufferC = nullptr;
+      }
+   HostBinding &binding = it->second;
+   cl_mem buffers[] = {binding.bufferA, binding.bufferB, binding.bufferC};
+   if (mode_ == MemMode::Pinned) {
+      void *hosts[] = {const_cast<int *>(binding.a), const_cast<int *>(binding.b), binding.c};
+      for (size_t k = 0; k < 3; ++k)
+         clEnqueueUnmapMemObject(map_queue_, buffers[k], hosts[k], 0, NULL, NULL);
+      clFinish(map_queue_);
+   }
+   for (cl_mem buffer : buffers)
+      clReleaseMemObject(buffer);
+   return host_bindings_.erase(it);
+}
+
+/**
+ * @brief Upload degli input secondo la modalità di memoria. Con ZeroCopy la map con
+ * CL_MAP_WRITE_INVALIDATE_REGION non legge nulla dal device, e la unmap rende visibili al
+ * device i vettori del task (senza copie se il device condivide la memoria dell'host).
+ */
+cl_int BufferManager::upload_inputs(const CommandQueues &queues, size_t index, const int *a,
+                                    const int *b, int *c, size_t bytes, cl_event *done,
+                                    std::vector<cl_event> *profile) {
+   BufferSet &buffer_set = buffer_pool_[index];
+
+   // Con Pinned i vettori vengono fissati in memoria e trasferiti da lì senza copie. Vettori
+   // non allineati alla pagina (nessun task del TaskPool) vengono trasferiti come con Copy.
+   if (mode_ == MemMode::Pinned && page_aligned(a) && page_aligned(b) && page_aligned(c) &&
+       !bind_host_memory(buffer_set, a, b, c, bytes))
+      return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+
+   if (mode_ != MemMode::ZeroCopy)
+      return queues.write_inputs(buffer_set.bufferA, buffer_set.bufferB, 0, bytes, a, b, done,
+                                 profile);
+
+   if (!bind_host_memory(buffer_set, a, b, c, bytes))
+      return CL_MEM_OBJECT_ALLOCATION_FAILURE;
+
+   cl_int ret = CL_SUCCESS;
+   cl_mem inputs[2] = {buffer_set.bufferA, buffer_set.bufferB};
+   cl_event unmaps[2] = {nullptr, nullptr};
+   for (size_t k = 0; k < 2 && ret == CL_SUCCESS; ++k) {
+      cl_event map_event = nullptr;
+      void *ptr = clEnqueueMapBuffer(queues.h2d, inputs[k], CL_FALSE,
+                                     CL_MAP_WRITE_INVALIDATE_REGION, 0, bytes, 0, NULL,
+                                     &map_event, &ret);
+      if (ret == CL_SUCCESS)
+         ret = clEnqueueUnmapMemObject(queues.h2d, inputs[k], ptr, 1, &map_event, &unmaps[k]);
+      keep_profile_event(profile, map_event);
+      if (map_event)
+         clReleaseEvent(map_event);
+   }
+   if (ret == CL_SUCCESS)
+      ret = clEnqueueMarkerWithWaitList(queues.h2d, 2, unmaps, done);
+
+   for (cl_event event : unmaps) {
+      keep_profile_event(profile, event);
+      if (event)
+         clReleaseEvent(event);
+   }
+   return ret;
+}
+
+/**
+ * @brief Accoda il download del risultato senza attenderlo. Con ZeroCopy la map con
+ * CL_MAP_READ aggiorna il vettore c stesso, che viene subito smappato dopo la map.
+ */
+cl_int BufferManager::start_download_output(const CommandQueues &queues, size_t index, int *c,
+                                            size_t bytes, cl_event after, cl_event *done,
+                                            std::vector<cl_event> *profile) {
+   BufferSet &buffer_set = buffer_pool_[index];
+   cl_int ret;
+
+   if (mode_ != MemMode::ZeroCopy) {
+      ret = clEnqueueReadBuffer(queues.d2h, buffer_set.bufferC, CL_FALSE, 0, bytes, c, 1,
+                                &after, done);
+      if (ret == CL_SUCCESS)
+         keep_profile_event(profile, *done);
+      return ret;
+   }
+
+   cl_event map_event = nullptr;
+   void *ptr = clEnqueueMapBuffer(queues.d2h, buffer_set.bufferC, CL_FALSE, CL_MAP_READ, 0,
+                                  bytes, 1, &after, &map_event, &ret);
+   if (ret != CL_SUCCESS)
+      return ret;
+
+   ret = clEnqueueUnmapMemObject(queues.d2h, buffer_set.bufferC, ptr, 1, &map_event, done);
+   keep_profile_event(profile, map_event);
+   if (ret == CL_SUCCESS)
+      keep_profile_event(profile, *done);
+   clReleaseEvent(map_event);
+   return ret;
+}
+
+/**
+ * @brief Download bloccante del risultato: accoda il download e lo attende.
+ */
+cl_int BufferManager::download_output(const CommandQueues &queues, size_t index, int *c,
+                                      size_t bytes, cl_event after,
+                                      std::vector<cl_event> *profile) {
+   cl_event done = nullptr;
+   cl_int ret = start_download_output(queues, index, c, bytes, after, &done, profile);
+   if (ret == CL_SUCCESS)
+      ret = clWaitForEvents(1, &done);
+   if (done)
+      clReleaseEvent(done);
+   return ret;
+}
+
 BufferManager::BufferSet &BufferManager::get_buffer_set(size_t index) {
    return buffer_pool_[index];
 }
\ No newline at end of file
@@ -1,8 +1,15 @@
 #pragma once
 
+#include "../../common/ComputeResult.hpp"
+#include "../../common/RunConfig.hpp"
+#include "CommandQueues.hpp"
+
+#include <array>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 #ifdef __APPLE__
@@ -13,48 +20,183 @@
 
 /**
  * @brief Gestisce un pool di set di buffer OpenCL. Incapsula la logica per
- * l'acquisizione, il rilascio e la riallocazione dei buffer di memoria sul
+ * l'acquisizione, il rilascio e l'allocazione dei buffer di memoria sul
  * device.
+ *
+ * Il pool è diviso in classi di dimensione: un set della classe k ha buffer da 2^k byte e
+ * serve tutti i task che richiedono fra 2^(k-1) e 2^k byte, ogni classe ha la propria lista
+ * di set liberi. Un task di dimensione nuova ottiene set della sua classe senza toccare quelli
+ * delle altre, quindi i buffer dei task in volo non vengono mai riallocati. I set delle
+ * dimensioni attese (RunConfig::expected_n e mixed_n) vengono allocati alla costruzione, in
+ * initialize(); le altre classi alla prima richiesta, liberando se serve set liberi di altre
+ * classi per restare nel budget.
+ *
+ * Incapsula anche i trasferimenti fra i vettori del task e i buffer, secondo la modalità di
+ * memoria (RunConfig::mem_mode):
+ * - Copy: clEnqueueWriteBuffer/clEnqueueReadBuffer fra i vettori del task e i buffer;
+ * - Pinned: come Copy, ma i vettori del task (allineati alla pagina, come gli slab del
+ *   TaskPool) vengono prima fissati in memoria: buffer CL_MEM_USE_HOST_PTR creati sui
+ *   vettori e mappati una volta sola, così i trasferimenti DMA partono direttamente dai
+ *   vettori del task, senza copie in uno staging. Come con ZeroCopy i binding restano in
+ *   cache, uno per slot del TaskPool;
+ * - ZeroCopy: i buffer vengono creati con CL_MEM_USE_HOST_PTR sui vettori del task e
+ *   sincronizzati con map/unmap. Su CPU e GPU integrate map e unmap non copiano nulla; su un
+ *   device discreto copiano solo i dati. I buffer creati su dei vettori restano in una cache
+ *   (host_bindings_) e vengono riusati dal set che riceve di nuovo quei vettori: ogni slot del
+ *   TaskPool viene legato una volta sola, anche se a ogni giro finisce in un set diverso.
+ *
+ * Il numero di set per classe non è fisso (RunConfig::pool_size). In modalità auto ogni classe
+ * parte da acc_stages + 1 set (uno per stadio della pipeline interna più uno in coda) e il
+ * pool si adatta a finestre di ADAPT_WINDOW acquisizioni: se l'attesa di un set libero occupa
+ * una parte rilevante della finestra aggiunge un set alla classe che ha atteso, e se il
+ * throughput della finestra successiva non migliora lo toglie e smette di crescere. Il pool
+ * non supera mai il budget di memoria (RunConfig::mem_budget_mb, di default 3/4 di
+ * CL_DEVICE_GLOBAL_MEM_SIZE), diviso fra i pool dei worker che condividono il dispositivo.
  */
 class BufferManager {
  public:
-   explicit BufferManager(cl_context context);
+   BufferManager(cl_context context, cl_device_id device, cl_command_queue map_queue,
+                 const RunConfig &config, size_t budget_share = 1);
    ~BufferManager();
 
+   // Buffer creati con CL_MEM_USE_HOST_PTR sui vettori di un task: con ZeroCopy sono i buffer
+   // del kernel, con Pinned restano mappati e tengono i vettori fissati in memoria.
+   struct HostBinding {
+      const int *a{nullptr}, *b{nullptr};
+      int *c{nullptr};
+      size_t bytes{0};
+      cl_mem bufferA{nullptr}, bufferB{nullptr}, bufferC{nullptr};
+      bool in_use{false}; // Legato a un set acquisito
+   };
+
    // Set di buffer, 2 per input e 1 per l'output.
    struct BufferSet {
       cl_mem bufferA{nullptr};
       cl_mem bufferB{nullptr};
       cl_mem bufferC{nullptr};
+
+      // Ultimo binding usato dal set: con ZeroCopy i buffer sopra ne sono alias, con Pinned
+      // fissa i vettori del task in uso.
+      HostBinding *binding{nullptr};
+
+      bool in_pool{false};   // Lo slot fa parte del pool (libero o in uso)
+      size_t size_class{0};  // Classe di dimensione del set
    };
 
-   // Metodi per l'acquisizione e il rilascio dei buffer.
-   size_t acquire_buffer_set();
+   // Metodi per l'acquisizione e il rilascio dei buffer. Il set acquisito ha buffer di almeno
+   // required_size_bytes byte.
+   size_t acquire_buffer_set(size_t required_size_bytes);
    void release_buffer_set(size_t index);
 
-   // Viene chiamata la prima volta o quando un task arriva con una
-   // dimensione di dati diversa da quella per cui i buffer sono stati allocati.
-   bool reallocate_buffers_if_needed(size_t required_size_bytes);
-
    // Restituisce un riferimento a un set di buffer specifico.
    BufferSet &get_buffer_set(size_t index);
 
+   /**
+    * @brief Upload di A e B (bytes byte) nel set 'index' sulla coda di upload. 'done' segnala
+    * che gli input sono sul device. Con ZeroCopy crea i buffer sui vettori a, b e c. Se
+    * 'profile' non è nullptr vi aggiunge gli eventi dei trasferimenti (profiling).
+    */
+   cl_int upload_inputs(const CommandQueues &queues, size_t index, const int *a, const int *b,
+                        int *c, size_t bytes, cl_event *done,
+                        std::vector<cl_event> *profile = nullptr);
+
+   /**
+    * @brief Download bloccante di C (bytes byte) dal set 'index' nel vettore c, dopo
+    * l'evento 'after' (il kernel).
+    */
+   cl_int download_output(const CommandQueues &queues, size_t index, int *c, size_t bytes,
+                          cl_event after, std::vector<cl_event> *profile = nullptr);
+
+   /**
+    * @brief Download asincrono di C: accoda sulla coda di download il trasferimento dopo
+    * l'evento 'after' e restituisce in 'done' l'evento del suo completamento, dopo il quale
+    * il risultato è in c.
+    */
+   cl_int start_download_output(const CommandQueues &queues, size_t index, int *c,
+                                size_t bytes, cl_event after, cl_event *done,
+                                std::vector<cl_event> *profile = nullptr);
+
+   // Aggiunge al risultato i set usati al massimo contemporaneamente e quelli nel pool.
+   void report_stats(ComputeResult &res);
+
  private:
-   cl_context context_; // Contesto OpenCL per creare i buffer
+   // Set di una classe di dimensione.
+   struct SizeClass {
+      std::queue<size_t> free;   // Indici dei set liberi
+      size_t active{0};          // Set della classe nel pool, liberi o in uso
+      size_t retire_pending{0};  // Set da togliere dal pool appena vengono rilasciati
+      bool used{false};          // La classe ha già avuto dei set
+   };
+
+   // Rilascia i buffer di un set (non quelli di un binding ZeroCopy).
+   void release_set(BufferSet &buffer_set);
+
+   // Alloca i buffer di un set (niente con ZeroCopy, i buffer seguono i vettori del task).
+   bool allocate_set(BufferSet &buffer_set, size_t bytes);
+
+   // Classe di dimensione per 'bytes' byte, capacità dei buffer dei suoi set e memoria del
+   // device che un suo set occupa (contata in pool_bytes_).
+   size_t class_of(size_t bytes) const;
+   size_t class_capacity(size_t size_class) const;
+   size_t set_device_bytes(size_t size_class) const;
+
+   // Con pool_mutex_ acquisito: aggiunge un set alla classe (con make_room liberando set
+   // liberi di altre classi se il budget è esaurito), o ne toglie uno libero.
+   bool grow_class(size_t size_class, bool make_room);
+   bool shrink_class(size_t size_class);
+   void retire_slot(size_t index);
+
+   // Con pool_mutex_ acquisito: chiude una finestra di adattamento se è completa.
+   void adapt_pool(size_t size_class, std::chrono::steady_clock::time_point start,
+                   long long wait_ns);
+
+   // ZeroCopy e Pinned: lega il set ai buffer dei vettori del task, creandoli solo se non sono
+   // già in cache. Con pool_mutex_ acquisito: rilascia i binding liberi della cache.
+   using HostBindings = std::unordered_multimap<const int *, HostBinding>;
+   bool bind_host_memory(BufferSet &buffer_set, const int *a, const int *b, int *c,
+                         size_t bytes);
+   void drop_free_bindings();
+   HostBindings::iterator erase_binding(HostBindings::iterator it);
+
+   cl_context context_;          // Contesto OpenCL per creare i buffer
+   cl_command_queue map_queue_;  // Coda per mappare e smappare i vettori fissati (Pinned)
+   MemMode mode_;                // Modalità di memoria
 
    // Dati per il pool di buffer nel device e per la gestione della concorrenza.
-   const size_t POOL_SIZE =
-      3; // ! Pool size OTTIMALE perchè con N = 7.449.999, i buffer per i vettori di input o
-         // ! output richiedono ~30MB l'uno, un set di buffer richiede quindi 90MB => sto già
-         // ! allocando POOL_SIZE x 90 = 270MB di VRAM, se aumentassi il pool size rischierei
-         // ! di rallentare l'OS o potrebber fallire l'alloc su FPGA, inoltre non aumenterebbe il
-         // ! throughput. Se usassi POOL_SIZE = 100, dovrei allocare 9GB di VRAM su FPGA. Con
-         // ! POOL_SIZE = 3 ho un buon compromesso fra performance e minimo utilizzo di memoria.
+   // ! In origine il pool era fisso a 3 set, scelto a mano per N = 7.449.999 su FPGA (3 set da
+   // ! 90MB): ora il limite viene dalla memoria del device e dal budget configurato.
+   static constexpr size_t MAX_POOL_SIZE = RunConfig::MAX_POOL_SETS; // Slot, fissi
+   static constexpr size_t ADAPT_WINDOW = 8;   // Acquisizioni per finestra di adattamento
+   static constexpr size_t MIN_CLASS = 12;     // Classe più piccola: buffer da 4KB
+   static constexpr size_t NUM_CLASSES = 48;   // Classe più grande: buffer da 2^47 byte
+   static constexpr size_t MAX_HOST_BINDINGS = 4096; // Binding in cache (slot del TaskPool)
    std::vector<BufferSet> buffer_pool_;
-   std::queue<size_t> free_buffer_indices_;
+   std::array<SizeClass, NUM_CLASSES> classes_;
+   std::vector<size_t> unused_slots_; // Slot fuori dal pool, senza buffer
+   // Binding per vettore c del task (lo slab di uno slot del TaskPool). I task senza
+   // pool condividono i vettori, quindi più binding possono avere la stessa chiave.
+   HostBindings host_bindings_;
    std::mutex pool_mutex_;
    std::condition_variable buffer_available_cond_;
 
-   // Dimensione attualmente allocata per i buffer nel pool.
-   size_t allocated_size_bytes_{0};
+   // Limiti del pool: memoria del device.
+   size_t memory_budget_bytes_{0}; // 0 = nessun limite noto
+   size_t max_alloc_bytes_{0};     // CL_DEVICE_MAX_MEM_ALLOC_SIZE, 0 = ignoto
+
+   // Stato del pool (protetto da pool_mutex_).
+   bool adaptive_;             // pool_size = auto
+   size_t initial_sets_;       // Set con cui parte ogni classe
+   size_t pool_bytes_{0};      // Memoria del device occupata dai set nel pool
+   size_t in_use_{0};          // Set attualmente in uso
+   size_t peak_in_use_{0};     // Massimo di set in uso contemporaneamente
+   size_t grown_class_{0};     // Classe dell'ultima crescita
+
+   // Finestra di adattamento corrente e throughput (acquisizioni/s) della precedente.
+   std::chrono::steady_clock::time_point window_start_;
+   size_t window_acquires_{0};
+   long long window_wait_ns_{0};
+   double last_rate_{0.0};
+   bool grew_last_{false};      // È stato aggiunto un set, da valutare
+   size_t settle_windows_{0};   // Finestre da ignorare dopo la crescita
+   bool converged_{false};      // Crescita inutile: il pool non cresce più
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../../common/Task.hpp"
+
+#include <cstddef>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+/**
+ * @brief Suddivisione di un task in chunk per l'esecuzione a chunk (RunConfig::chunk_size).
+ *
+ * Ogni chunk è un sotto-intervallo [offset, offset + count) dei vettori del task, che viene
+ * caricato, calcolato e scaricato indipendentemente dagli altri. Così l'upload del chunk k+1
+ * si sovrappone al calcolo del chunk k e al download del chunk k-1.
+ */
+struct ChunkRange {
+   size_t offset; // Primo elemento del chunk
+   size_t count;  // Numero di elementi del chunk
+};
+
+/**
+ * @brief Divide n elementi in chunk da chunk_elems elementi (l'ultimo può essere più corto).
+ * @param align_elems La dimensione dei chunk viene arrotondata a un multiplo di questo valore,
+ * per rispettare l'allineamento richiesto dal device per i sub-buffer.
+ */
+inline std::vector<ChunkRange> split_in_chunks(size_t n, size_t chunk_elems,
+                                               size_t align_elems = 1) {
+   if (align_elems > 1)
+      chunk_elems = (chunk_elems + align_elems - 1) / align_elems * align_elems;
+   if (chunk_elems == 0 || chunk_elems >= n)
+      return {{0, n}};
+
+   std::vector<ChunkRange> chunks;
+   for (size_t offset = 0; offset < n; offset += chunk_elems)
+      chunks.push_back({offset, (n - offset < chunk_elems) ? n - offset : chunk_elems});
+   return chunks;
+}
+
+/**
+ * @brief Rilascia gli eventi dei chunk del task e svuota la lista. Su un errore a metà di un
+ * ciclo sui chunk libera gli eventi già raccolti; la lista vuota segnala agli stadi
+ * successivi che il task non ha più chunk da attendere.
+ */
+inline void release_chunk_events(Task *task) {
+   for (cl_event event : task->chunk_events)
+      if (event)
+         clReleaseEvent(event);
+   task->chunk_events.clear();
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "../../common/RunConfig.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+/**
+ * @brief Code di comandi di un acceleratore OpenCL (Gpu_OpenCL_Accelerator, Fpga_Accelerator).
+ *
+ * Upload, kernel e download vengono accodati rispettivamente su h2d, compute e d2h, che
+ * coincidono con una sola coda quando i trasferimenti non hanno code proprie. L'ordine fra gli
+ * stadi di un task è dato solo dagli eventi, quindi gli stessi stadi funzionano con:
+ * - una coda in-order (default): i comandi vengono eseguiti nell'ordine di accodamento;
+ * - una coda out-of-order: il runtime può eseguire l'upload di un task durante il kernel del
+ *   precedente e il download durante il kernel del successivo;
+ * - tre code in-order separate (split, e sempre con l'esecuzione a chunk), con lo stesso
+ *   effetto anche sui runtime che non supportano le code out-of-order.
+ */
+struct CommandQueues {
+   cl_command_queue h2d{nullptr};     // Upload degli input
+   cl_command_queue compute{nullptr}; // Esecuzione del kernel
+   cl_command_queue d2h{nullptr};     // Download dei risultati
+   bool out_of_order{false};          // Code create con CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE
+
+   /**
+    * @brief Crea le code secondo 'mode'. Con split_transfers (esecuzione a chunk) upload e
+    * download hanno comunque code proprie. Se il dispositivo non supporta le code out-of-order
+    * ripiega sulle tre code in-order.
+    * @param profiling Crea le code con CL_QUEUE_PROFILING_ENABLE (RunConfig::profile).
+    * @param tag Nome dell'acceleratore, per i messaggi di log.
+    */
+   bool create(cl_context context, cl_device_id device, ClQueueMode mode, bool split_transfers,
+               bool profiling, const std::string &tag) {
+      cl_command_queue_properties properties = profiling ? CL_QUEUE_PROFILING_ENABLE : 0;
+      if (mode == ClQueueMode::OutOfOrder) {
+         cl_command_queue_properties supported = 0;
+         clGetDeviceInfo(device, CL_DEVICE_QUEUE_PROPERTIES, sizeof(supported), &supported,
+                         NULL);
+         if (supported & CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE) {
+            properties |= CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE;
+            out_of_order = true;
+         } else {
+            std::cerr << "[WARNING] " << tag << ": Out-of-order queues not supported, "
+                      << "using split in-order queues.\n";
+            mode = ClQueueMode::Split;
+         }
+      }
+
+      cl_int ret;
+      compute = clCreateCommandQueue(context, device, properties, &ret);
+      if (!compute || ret != CL_SUCCESS) {
+         std::cerr << "[ERROR] " << tag << ": Failed to create command queue.\n";
+         return false;
+      }
+
+      if (mode == ClQueueMode::Split || split_transfers) {
+         h2d = clCreateCommandQueue(context, device, properties, &ret);
+         d2h = clCreateCommandQueue(context, device, properties, &ret);
+         if (!h2d || !d2h) {
+            std::cerr << "[ERROR] " << tag << ": Failed to create transfer queues.\n";
+            return false;
+         }
+      } else {
+         h2d = d2h = compute;
+      }
+
+      if (out_of_order || separate())
+         std::cerr << "[" << tag << "] Command queues: "
+                   << (out_of_order ? "out-of-order" : "in-order") << ", "
+                   << (separate() ? "split upload/compute/download" : "shared") << ".\n";
+      return true;
+   }
+
+   void release() {
+      if (d2h && d2h != compute)
+         clReleaseCommandQueue(d2h);
+      if (h2d && h2d != compute)
+         clReleaseCommandQueue(h2d);
+      if (compute)
+         clReleaseCommandQueue(compute);
+      h2d = compute = d2h = nullptr;
+   }
+
+   // Upload e download hanno code diverse da quella del kernel.
+   bool separate() const { return h2d != compute; }
+
+   /**
+    * @brief Avvia i comandi accodati su 'queue' senza attendere il flush implicito di una
+    * chiamata bloccante: serve quando gli stadi successivi sono su altre code o possono essere
+    * riordinati. Con una sola coda in-order non fa nulla, come in origine.
+    */
+   void submit(cl_command_queue queue) const {
+      if (out_of_order || separate())
+         clFlush(queue);
+   }
+
+   /**
+    * @brief Accoda su h2d la scrittura di [offset, offset + size) byte di A e B e restituisce
+    * in 'done' un evento che segnala il completamento di entrambe. Su una coda in-order basta
+    * l'evento della seconda scrittura, su una out-of-order i due eventi vengono uniti da un
+    * marker. Se 'profile' non è nullptr vi aggiunge gli eventi delle due scritture.
+    */
+   cl_int write_inputs(cl_mem buffer_a, cl_mem buffer_b, size_t offset, size_t size,
+                       const int *host_a, const int *host_b, cl_event *done,
+                       std::vector<cl_event> *profile = nullptr) const {
+      cl_int ret;
+      if (!out_of_order && !profile) {
+         ret = clEnqueueWriteBuffer(h2d, buffer_a, CL_FALSE, offset, size, host_a, 0, NULL,
+                                    NULL);
+         if (ret != CL_SUCCESS)
+            return ret;
+         return clEnqueueWriteBuffer(h2d, buffer_b, CL_FALSE, offset, size, host_b, 0, NULL,
+                                     done);
+      }
+
+      cl_event writes[2] = {nullptr, nullptr};
+      ret = clEnqueueWriteBuffer(h2d, buffer_a, CL_FALSE, offset, size, host_a, 0, NULL,
+                                 &writes[0]);
+      if (ret == CL_SUCCESS)
+         ret = clEnqueueWriteBuffer(h2d, buffer_b, CL_FALSE, offset, size, host_b, 0, NULL,
+                                    &writes[1]);
+      if (ret == CL_SUCCESS) {
+         if (out_of_order) {
+            ret = clEnqueueMarkerWithWaitList(h2d, 2, writes, done);
+         } else {
+            clRetainEvent(writes[1]);
+            *done = writes[1];
+         }
+      }
+
+      for (cl_event event : writes) {
+         if (event && profile)
+            profile->push_back(event);
+         else if (event)
+            clReleaseEvent(event);
+      }
+      return ret;
+   }
+};
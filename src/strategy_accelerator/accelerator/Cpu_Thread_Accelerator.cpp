@@ -0,0 +1,311 @@
+#include "Cpu_Thread_Accelerator.hpp"
+#include "../../common/Tracer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+/**
+ * @brief Implementazione della classe Cpu_Thread_Accelerator: la CPU dell'host usata come
+ * device della pipeline di offloading.
+ */
+
+// Elementi minimi di una fetta di kernel: i task piccoli non vengono divisi fra tutti i
+// thread del device, il costo della coda supererebbe quello del calcolo.
+static constexpr long MIN_SLICE_ELEMS = 16384;
+
+/**
+ * Stato di un kernel lanciato. Le fette lo aggiornano dai thread del device, l'ultima che
+ * termina lo segna come completato e, se è stata registrata una callback, esegue il download.
+ * Ce n'è uno per buffer set, riusato dal task successivo sullo stesso set.
+ */
+struct Cpu_Thread_Accelerator::Launch {
+   Task *task{nullptr};
+   BufferSet *buffers{nullptr};
+   std::atomic<size_t> pending_slices{0};
+
+   // Istanti di accodamento, inizio della prima fetta e fine dell'ultima (ns dell'orologio
+   // steady), e richiesta del download.
+   long long queued_ns{0};
+   std::atomic<long long> start_ns{0};
+   long long end_ns{0};
+   Clock::time_point download_requested;
+
+   std::mutex mutex;
+   std::condition_variable done_cond;
+   bool done{false};
+   CompletionFn on_complete{nullptr};
+   void *user_data{nullptr};
+};
+
+static long long now_ns() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static long long elapsed_ns(std::chrono::steady_clock::time_point from,
+                            std::chrono::steady_clock::time_point to) {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+Cpu_Thread_Accelerator::Cpu_Thread_Accelerator(const std::string &kernel_name,
+                                               const RunConfig &config)
+    : kernel_name_(kernel_name), config_(config) {}
+
+/**
+ * @brief Il distruttore accoda una fetta vuota per ogni thread del device e li attende.
+ */
+Cpu_Thread_Accelerator::~Cpu_Thread_Accelerator() {
+   for (size_t t = 0; t < threads_.size(); ++t)
+      commands_.push(Slice{});
+   for (auto &thread : threads_)
+      thread.join();
+
+   std::cerr << "[Cpu_Thread_Accelerator] Destroyed and resources released.\n";
+}
+
+/**
+ * @brief Esegue tutte le operazioni di setup una volta sola: sceglie il kernel, avvia i thread
+ * del device e alloca il pool di buffer per la dimensione attesa dei task.
+ */
+bool Cpu_Thread_Accelerator::initialize() {
+   kernel_fn_ = select_cpu_kernel(kernel_name_, config_.simd, &simd_);
+   if (!kernel_fn_) {
+      std::cerr << "[ERROR] Cpu_Thread_Accelerator: Unknown kernel name '" << kernel_name_
+                << "'.\n"
+                << "    --> Supported kernels are: 'vecAdd', 'polynomial_op', "
+                   "'heavy_compute_kernel'.\n";
+      return false;
+   }
+
+   // Thread del device: di default i core lasciati liberi da Emitter, collector e, per ogni
+   // worker della farm (RunConfig::acc_workers), nodo ff_node_acc_t e stadi della sua pipeline
+   // interna, divisi fra i worker come in HybridFarmRunner: ogni worker ha il proprio device.
+   num_threads_ = config_.cpu_threads;
+   if (num_threads_ == 0) {
+      size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+      size_t workers = std::max<size_t>(config_.acc_workers, 1);
+      size_t reserved = 2 + workers * (config_.acc_stages + 1);
+      num_threads_ = std::max<size_t>((cores > reserved ? cores - reserved : 0) / workers, 1);
+   }
+   for (size_t t = 0; t < num_threads_; ++t)
+      threads_.emplace_back(&Cpu_Thread_Accelerator::device_loop, this);
+
+   // Un set per stadio della pipeline interna più uno in coda, come il pool di BufferManager.
+   size_t pool_size = config_.pool_size > 0 ? config_.pool_size : config_.acc_stages + 1;
+   pool_.resize(pool_size);
+   for (size_t i = 0; i < pool_size; ++i) {
+      pool_[i].a.resize(config_.expected_n);
+      pool_[i].b.resize(config_.expected_n);
+      pool_[i].c.resize(config_.expected_n);
+      free_sets_.push_back(pool_size - 1 - i);
+   }
+
+   // Un lancio per set: il set è di un solo task dall'upload al download, così il lancio può
+   // essere riusato senza allocazioni per task.
+   launches_.resize(pool_size);
+   for (auto &launch : launches_)
+      launch = std::make_unique<Launch>();
+
+   device_name_ = "CPU threads (" + std::to_string(num_threads_) + ", SIMD " +
+                  simd_name(simd_) + ")";
+   std::cerr << "[Cpu_Thread_Accelerator] Initialization successful: " << device_name_
+             << ", " << pool_size << " buffer sets.\n";
+   return true;
+}
+
+/**
+ * @brief Stadio 1 (Upload): copia gli input del task nel buffer set acquisito.
+ */
+void Cpu_Thread_Accelerator::send_data_to_device(void *task_context) {
+   auto *task = static_cast<Task *>(task_context);
+   auto &buffers = pool_[task->buffer_idx];
+
+   auto t0 = Clock::now();
+   std::memcpy(buffers.a.data(), task->a, sizeof(int) * task->n);
+   std::memcpy(buffers.b.data(), task->b, sizeof(int) * task->n);
+   if (config_.profile) {
+      task->device_ns = {};
+      task->device_ns[DEVICE_H2D] = elapsed_ns(t0, Clock::now());
+   }
+}
+
+/**
+ * @brief Stadio 2 (Execute): divide il kernel in fette, una per thread del device, e le
+ * accoda senza attenderle. L'handle del lancio resta in Task::sync_handle.
+ */
+void Cpu_Thread_Accelerator::execute_kernel(void *task_context) {
+   auto *task = static_cast<Task *>(task_context);
+   const long n = static_cast<long>(task->n);
+   const long slices = std::clamp<long>(n / MIN_SLICE_ELEMS, 1, long(num_threads_));
+
+   Launch *launch = launches_[task->buffer_idx].get();
+   launch->task = task;
+   launch->buffers = &pool_[task->buffer_idx];
+   launch->pending_slices = size_t(slices);
+   launch->start_ns = 0;
+   launch->done = false;
+   launch->on_complete = nullptr;
+   launch->user_data = nullptr;
+   launch->queued_ns = now_ns();
+   task->sync_handle = launch;
+
+   for (long s = 0; s < slices; ++s)
+      commands_.push(Slice{launch, n * s / slices, n * (s + 1) / slices});
+}
+
+/**
+ * @brief Loop dei thread del device: esegue le fette accodate fino alla fetta vuota.
+ */
+void Cpu_Thread_Accelerator::device_loop() {
+   Tracer::set_thread_name("CPU Device");
+   while (true) {
+      Slice slice = commands_.pop();
+      if (!slice.launch)
+         break;
+
+      Launch *launch = slice.launch;
+      long long no_start = 0;
+      launch->start_ns.compare_exchange_strong(no_start, now_ns());
+
+      BufferSet &buffers = *launch->buffers;
+      kernel_fn_(buffers.a.data(), buffers.b.data(), buffers.c.data(), slice.start, slice.end);
+
+      if (launch->pending_slices.fetch_sub(1, std::memory_order_acq_rel) == 1)
+         complete_launch(launch);
+   }
+}
+
+/**
+ * @brief Chiamata dall'ultima fetta del kernel: segna il lancio come completato e, se è già
+ * stata registrata una callback, esegue il download su questo thread e la chiama.
+ */
+void Cpu_Thread_Accelerator::complete_launch(Launch *launch) {
+   CompletionFn on_complete;
+   {
+      std::lock_guard<std::mutex> lock(launch->mutex);
+      launch->end_ns = now_ns();
+      launch->done = true;
+      on_complete = launch->on_complete;
+      // Il Consumer in attesa può rilasciare il set, e riusare il lancio per un altro task,
+      // appena rilasciato il lock.
+      launch->done_cond.notify_all();
+   }
+
+   if (on_complete) {
+      Task *task = launch->task;
+      void *user_data = launch->user_data;
+      download(launch);
+      on_complete(task, user_data);
+   }
+}
+
+/**
+ * @brief Copia l'output del kernel nel task, registra i tempi del lancio e scollega l'handle.
+ */
+void Cpu_Thread_Accelerator::download(Launch *launch) {
+   Task *task = launch->task;
+   auto t0 = Clock::now();
+   std::memcpy(task->c, launch->buffers->c.data(), sizeof(int) * task->n);
+   auto t1 = Clock::now();
+
+   long long kernel_ns = launch->end_ns - launch->start_ns.load();
+   if (config_.profile) {
+      task->device_ns[DEVICE_KERNEL] = kernel_ns;
+      task->device_ns[DEVICE_D2H] = elapsed_ns(t0, t1);
+      task->device_ns[DEVICE_QUEUED] = launch->start_ns.load() - launch->queued_ns;
+      task->profiled = true;
+   }
+
+   // Come per OpenCL: con il profiling il tempo di calcolo è quello del kernel sul device,
+   // altrimenti l'attesa del kernel e del download vista dall'host.
+   task->computed_ns =
+      config_.profile ? kernel_ns : elapsed_ns(launch->download_requested, t1);
+   task->sync_handle = nullptr;
+}
+
+/**
+ * @brief Stadio 3 (Download): attende il completamento del kernel e copia i risultati.
+ */
+void Cpu_Thread_Accelerator::get_results_from_device(void *task_context,
+                                                     long long &computed_ns) {
+   auto *task = static_cast<Task *>(task_context);
+   auto *launch = static_cast<Launch *>(task->sync_handle);
+   launch->download_requested = Clock::now();
+   {
+      std::unique_lock<std::mutex> lock(launch->mutex);
+      launch->done_cond.wait(lock, [launch] { return launch->done; });
+   }
+
+   download(launch);
+   computed_ns = task->computed_ns;
+}
+
+/**
+ * @brief Stadio 3 - Download asincrono: registra la callback, che l'ultima fetta del kernel
+ * chiamerà dopo il download. Se il kernel è già terminato esegue subito il download.
+ */
+void Cpu_Thread_Accelerator::start_results_download(void *task_context,
+                                                    CompletionFn on_complete,
+                                                    void *user_data) {
+   auto *task = static_cast<Task *>(task_context);
+   auto *launch = static_cast<Launch *>(task->sync_handle);
+   launch->download_requested = Clock::now();
+   {
+      std::lock_guard<std::mutex> lock(launch->mutex);
+      if (!launch->done) {
+         launch->on_complete = on_complete;
+         launch->user_data = user_data;
+         return;
+      }
+   }
+
+   download(launch);
+   on_complete(task, user_data);
+}
+
+// ------------------------------------------------------------------------
+// Metodi per l'acquisizione e il rilascio dei buffer
+// ------------------------------------------------------------------------
+
+/**
+ * @brief Acquisisce un set libero, attendendo se sono tutti in uso. I buffer di un set più
+ * piccolo del task vengono ingranditi: il set non è usato da nessun altro task.
+ */
+size_t Cpu_Thread_Accelerator::acquire_buffer_set(size_t required_size_bytes) {
+   size_t index;
+   {
+      std::unique_lock<std::mutex> lock(pool_mutex_);
+      set_available_.wait(lock, [this] { return !free_sets_.empty(); });
+      index = free_sets_.back();
+      free_sets_.pop_back();
+      peak_in_use_ = std::max(peak_in_use_, pool_.size() - free_sets_.size());
+   }
+
+   size_t elems = (required_size_bytes + sizeof(int) - 1) / sizeof(int);
+   BufferSet &buffers = pool_[index];
+   if (buffers.a.size() < elems) {
+      buffers.a.resize(elems);
+      buffers.b.resize(elems);
+      buffers.c.resize(elems);
+   }
+   return index;
+}
+
+void Cpu_Thread_Accelerator::release_buffer_set(size_t index) {
+   {
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      free_sets_.push_back(index);
+   }
+   set_available_.notify_one();
+}
+
+void Cpu_Thread_Accelerator::report_stats(ComputeResult &res) {
+   add_device_name(res, device_name_);
+   std::lock_guard<std::mutex> lock(pool_mutex_);
+   res.buffer_sets_peak += peak_in_use_;
+   res.buffer_sets_final += pool_.size();
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../../common/AlignedAllocator.hpp"
+#include "../../common/BlockingQueue.hpp"
+#include "../../common/RunConfig.hpp"
+#include "../../strategy_cpu/SimdKernels.hpp"
+#include "IAccelerator.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Implementazione di IAccelerator che usa la CPU dell'host come device, per eseguire e
+ * misurare la pipeline di offloading (ff_node_acc_t) senza GPU né FPGA.
+ *
+ * Il "device" ha:
+ * - un pool di thread propri (RunConfig::cpu_threads, 0 = i core non usati dalla pipeline,
+ *   divisi fra i worker della farm),
+ *   che prelevano da una coda di comandi le fette dei kernel lanciati;
+ * - una "memoria del device": un pool di set di buffer (RunConfig::pool_size, 0 = acc_stages
+ *   + 1), in cui l'Upload copia gli input del task e da cui il Download copia l'output;
+ * - lanci asincroni: execute_kernel() accoda il kernel e ritorna subito, salvando in
+ *   Task::sync_handle l'handle del lancio, che get_results_from_device() attende come il
+ *   command buffer di Gpu_Metal_Accelerator. Con RunConfig::completion = Callback il download
+ *   viene eseguito dal thread del device che completa il kernel, che poi chiama la callback.
+ *
+ * Con RunConfig::profile i tempi di upload, kernel, download e attesa nella coda di comandi
+ * vengono misurati per ogni task, come i tempi degli eventi OpenCL.
+ */
+class Cpu_Thread_Accelerator : public IAccelerator {
+ public:
+   /**
+    * @param kernel_name Nome del kernel CPU ('vecAdd', 'polynomial_op', ...).
+    * @param config Opzioni di esecuzione (thread del device, pool, SIMD, profiling).
+    */
+   Cpu_Thread_Accelerator(const std::string &kernel_name,
+                          const RunConfig &config = RunConfig());
+   ~Cpu_Thread_Accelerator() override;
+
+   // Sceglie il kernel, avvia i thread del device e alloca il pool di buffer.
+   bool initialize() override;
+
+   // Metodi utili per i thread della pipeline interna.
+   void send_data_to_device(void *task_context) override;
+   void execute_kernel(void *task_context) override;
+   void get_results_from_device(void *task_context, long long &computed_ns) override;
+   void start_results_download(void *task_context, CompletionFn on_complete,
+                               void *user_data) override;
+
+   // Metodi per l'acquisizione e il rilascio dei buffer.
+   size_t acquire_buffer_set(size_t required_size_bytes) override;
+   void release_buffer_set(size_t index) override;
+
+   // Nome del dispositivo e uso del pool di buffer.
+   void report_stats(ComputeResult &res) override;
+
+ private:
+   using Clock = std::chrono::steady_clock;
+
+   // Set di buffer nella "memoria del device", 2 per input e 1 per l'output.
+   struct BufferSet {
+      HostVector<int> a, b, c;
+   };
+
+   // Stato di un kernel lanciato, salvato in Task::sync_handle fino al download.
+   struct Launch;
+
+   // Fetta [start, end) di un kernel, eseguita da un thread del device (launch nullptr =
+   // terminazione del thread).
+   struct Slice {
+      Launch *launch{nullptr};
+      long start{0};
+      long end{0};
+   };
+
+   void device_loop();
+   void complete_launch(Launch *launch);
+   void download(Launch *launch);
+
+   std::string kernel_name_;
+   std::string device_name_;
+   RunConfig config_;
+   KernelRangeFn kernel_fn_{nullptr};
+   SimdMode simd_{SimdMode::Off};
+   size_t num_threads_{0};
+
+   // Coda di comandi e thread del device.
+   BlockingQueue<Slice> commands_;
+   std::vector<std::thread> threads_;
+
+   // Pool di buffer set.
+   std::vector<BufferSet> pool_;
+   std::vector<size_t> free_sets_;
+   std::mutex pool_mutex_;
+   std::condition_variable set_available_;
+   size_t peak_in_use_{0};
+
+   // Lanci, uno per buffer set (indice Task::buffer_idx).
+   std::vector<std::unique_ptr<Launch>> launches_;
+};
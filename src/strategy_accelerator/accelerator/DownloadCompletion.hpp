@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../../common/Task.hpp"
+#include "IAccelerator.hpp"
+
+#include <chrono>
+#include <iostream>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+/**
+ * @brief Completamento di un download asincrono di Gpu_OpenCL_Accelerator e Fpga_Accelerator.
+ *
+ * Registra con clSetEventCallback una callback sull'evento che segnala la fine del download.
+ * Il runtime OpenCL la chiama da un proprio thread quando l'evento è completo: la callback
+ * scrive in Task::computed_ns il tempo trascorso dall'accodamento e passa il task alla
+ * funzione di completamento del nodo. Nessun thread resta bloccato sul download di un singolo
+ * task, e i task possono completare in un ordine diverso da quello di lancio.
+ */
+struct DownloadCompletion {
+   Task *task;
+   IAccelerator::CompletionFn on_complete;
+   void *user_data;
+   std::chrono::steady_clock::time_point start; // Accodamento del download
+
+   /**
+    * @brief Chiama on_complete al completamento di 'done', di cui prende il possesso. Se la
+    * callback non può essere registrata attende l'evento e completa subito il task.
+    */
+   static void notify(cl_event done, Task *task, IAccelerator::CompletionFn on_complete,
+                      void *user_data, std::chrono::steady_clock::time_point start) {
+      auto *pending = new DownloadCompletion{task, on_complete, user_data, start};
+      cl_int ret =
+         clSetEventCallback(done, CL_COMPLETE, &DownloadCompletion::completed, pending);
+      if (ret != CL_SUCCESS) {
+         std::cerr << "[ERROR] clSetEventCallback failed with code " << ret << ".\n";
+         clWaitForEvents(1, &done);
+         completed(done, CL_COMPLETE, pending);
+      }
+   }
+
+   /**
+    * @brief Completa un task il cui download non è stato accodato, così il nodo non lo
+    * attende all'infinito.
+    */
+   static void fail(Task *task, IAccelerator::CompletionFn on_complete, void *user_data) {
+      task->computed_ns = 0;
+      on_complete(task, user_data);
+   }
+
+ private:
+   // Callback del runtime OpenCL: chiamata anche se il download termina con un errore.
+   static void CL_CALLBACK completed(cl_event event, cl_int status, void *data) {
+      auto *pending = static_cast<DownloadCompletion *>(data);
+      if (status != CL_COMPLETE)
+         std::cerr << "[ERROR] Download of task " << pending->task->id
+                   << " failed with code " << status << ".\n";
+
+      pending->task->computed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                      std::chrono::steady_clock::now() - pending->start)
+                                      .count();
+      clReleaseEvent(event);
+      pending->on_complete(pending->task, pending->user_data);
+      delete pending;
+   }
+};
@@ -1,5 +1,9 @@
 #include "Fpga_Accelerator.hpp"
+#include "Chunking.hpp"
+#include "DownloadCompletion.hpp"
+#include "Profiling.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <filesystem>
 #include <fstream>
@@ -24,24 +28,28 @@
 
 /**
  * @brief Il costruttrore prende in input il nome della funzione kernel e il suo
- * path.
+ * path e le opzioni di esecuzione (dimensione dei chunk, code di comandi e modalità
+ * di memoria).
  */
 Fpga_Accelerator::Fpga_Accelerator(const std::string &kernel_path,
-                                   const std::string &kernel_name)
-    : kernel_path_(kernel_path), kernel_name_(kernel_name) {}
+                                   const std::string &kernel_name, const RunConfig &config)
+    : kernel_path_(kernel_path), kernel_name_(kernel_name), chunk_size_(config.chunk_size),
+      queue_mode_(config.cl_queue_mode), mem_mode_(config.mem_mode),
+      config_(config) {}
 
 /**
  * @brief Il distruttore si occupa di rilasciare in ordine inverso tutte le
- risorse OpenCL allocate. La pulizia dei buffer è gestita automaticamente dal
- distruttore di buffer_manager_.
+ risorse OpenCL allocate. La pulizia dei buffer è gestita dal distruttore di
+ buffer_manager_, chiamato per primo perché con la memoria pinned usa la coda
+ di comandi.
  */
 Fpga_Accelerator::~Fpga_Accelerator() {
+   buffer_manager_.reset();
    if (kernel_)
       clReleaseKernel(kernel_);
    if (program_)
       clReleaseProgram(program_);
-   if (queue_)
-      clReleaseCommandQueue(queue_);
+   queues_.release();
    if (context_)
       clReleaseContext(context_);
 
@@ -67,6 +75,10 @@ bool Fpga_Accelerator::initialize() {
                 exit(EXIT_FAILURE);
              });
 
+   char device_name[256] = {0};
+   clGetDeviceInfo(device_id, CL_DEVICE_NAME, sizeof(device_name) - 1, device_name, NULL);
+   device_name_ = device_name;
+
    // Crea un contesto
    context_ = clCreateContext(NULL, 1, &device_id, NULL, NULL, &ret);
    if (!context_) {
@@ -74,15 +86,34 @@ bool Fpga_Accelerator::initialize() {
       return false;
    }
 
-   // Crea la coda di comandi
-   queue_ = clCreateCommandQueue(context_, device_id, 0, &ret);
-   if (!queue_) {
-      std::cerr << "[ERROR] Fpga_Accelerator: Failed to create command queue.\n";
+   // L'esecuzione a chunk usa sub-buffer dei buffer del pool, quindi solo la memoria in
+   // modalità copy.
+   if (chunk_size_ > 0 && mem_mode_ != MemMode::Copy) {
+      std::cerr << "[WARNING] Fpga_Accelerator: Chunked execution requires --mem=copy, "
+                   "running whole tasks.\n";
+      chunk_size_ = 0;
+   }
+
+   // Crea le code di comandi. L'esecuzione a chunk usa sempre code separate per upload e
+   // download.
+   if (!queues_.create(context_, device_id, queue_mode_, chunk_size_ > 0, config_.profile,
+                       "Fpga_Accelerator"))
       return false;
+
+   // Con l'esecuzione a chunk legge l'allineamento richiesto per l'origine dei sub-buffer
+   // (in bit).
+   if (chunk_size_ > 0) {
+      cl_uint align_bits = 0;
+      clGetDeviceInfo(device_id, CL_DEVICE_MEM_BASE_ADDR_ALIGN, sizeof(align_bits),
+                      &align_bits, NULL);
+      chunk_align_elems_ = std::max<size_t>(align_bits / 8 / sizeof(int), 1);
+      std::cerr << "[Fpga_Accelerator] Chunked execution: " << chunk_size_
+                << " elements per chunk (alignment " << chunk_align_elems_ << ").\n";
    }
 
    // Chiama il costruttore di BufferManager che iniializza il pool di buffer.
-   buffer_manager_ = std::make_unique<BufferManager>(context_);
+   buffer_manager_ =
+      std::make_unique<BufferManager>(context_, device_id, queues_.compute, config_);
 
    // Caricamento del file binario dell'FPGA (.xclbin).
    std::ifstream binaryFile(kernel_path_, std::ios::binary);
@@ -130,9 +161,9 @@ bool Fpga_Accelerator::initialize() {
 /**
  * @brief Stadio 1 (Upload).
  * Fa l'upload dei dati di input A e B dall'host alla device memory.
- * L'evento per la sincronizzazione (`task->event`) viene generato solo
- * dall'ultima operazione, garantendo che lo stadio successivo attenda il
- * completamento di entrambi i trasferimenti.
+ * L'evento per la sincronizzazione (`task->event`) segnala il completamento
+ * di entrambi i trasferimenti (anche su una coda out-of-order), garantendo che
+ * lo stadio successivo li attenda.
  */
 void Fpga_Accelerator::send_data_to_device(void *task_context) {
    cl_int ret; // Codice di ritorno delle chiamate OpenCL
@@ -141,21 +172,22 @@ void Fpga_Accelerator::send_data_to_device(void *task_context) {
    std::cerr << "[Fpga_Accelerator - START] Processing task " << task->id
              << " with N=" << task->n << "...\n";
 
-   // Se la dimensione richiesta è diversa da quella allocata, rialloca
-   // tutti i buffer del pool e ottieni il set di buffer.
+   // Il set di buffer acquisito per il task ha buffer di almeno N elementi.
    size_t required_size_bytes = sizeof(int) * task->n;
-   buffer_manager_->reallocate_buffers_if_needed(required_size_bytes);
    auto &current_buffers = buffer_manager_->get_buffer_set(task->buffer_idx);
 
-   // Scrive i due input sulla device memory.
-   OCL_CHECK(ret,
-             clEnqueueWriteBuffer(queue_, current_buffers.bufferA, CL_FALSE, 0,
-                                  required_size_bytes, task->a, 0, NULL, NULL),
-             return);
+   if (chunk_size_ > 0) {
+      send_chunks_to_device(task, current_buffers);
+      return;
+   }
+
+   // Scrive i due input sulla device memory (o li rende visibili al device, con zero-copy).
    OCL_CHECK(ret,
-             clEnqueueWriteBuffer(queue_, current_buffers.bufferB, CL_FALSE, 0,
-                                  required_size_bytes, task->b, 0, NULL, &task->event),
+             buffer_manager_->upload_inputs(queues_, task->buffer_idx, task->a, task->b,
+                                            task->c, required_size_bytes, &task->event,
+                                            profile_events(task, DEVICE_H2D, config_.profile)),
              return);
+   queues_.submit(queues_.h2d);
 }
 
 /**
@@ -167,6 +199,12 @@ void Fpga_Accelerator::send_data_to_device(void *task_context) {
 void Fpga_Accelerator::execute_kernel(void *task_context) {
    cl_int ret; // Codice di ritorno delle chiamate OpenCL.
    auto *task = static_cast<Task *>(task_context);
+
+   if (chunk_size_ > 0) {
+      execute_chunks(task);
+      return;
+   }
+
    auto &current_buffers = buffer_manager_->get_buffer_set(task->buffer_idx);
    cl_event previous_event = task->event;
 
@@ -180,7 +218,11 @@ void Fpga_Accelerator::execute_kernel(void *task_context) {
    OCL_CHECK(ret, clSetKernelArg(kernel_, 3, sizeof(int), &(task->n)), return);
 
    // Accoda l'esecuzione del kernel.
-   OCL_CHECK(ret, clEnqueueTask(queue_, kernel_, 1, &previous_event, &task->event), return);
+   OCL_CHECK(ret,
+             clEnqueueTask(queues_.compute, kernel_, 1, &previous_event, &task->event),
+             return);
+   keep_profile_event(profile_events(task, DEVICE_KERNEL, config_.profile), task->event);
+   queues_.submit(queues_.compute);
 
    // Rilascia l'evento precedente.
    if (previous_event)
@@ -197,36 +239,246 @@ void Fpga_Accelerator::get_results_from_device(void *task_context, long long &co
    cl_int ret; // Codice di ritorno delle chiamate OpenCL
    auto *task = static_cast<Task *>(task_context);
    size_t required_size_bytes = sizeof(int) * task->n;
-   auto &current_buffers = buffer_manager_->get_buffer_set(task->buffer_idx);
    cl_event previous_event = task->event;
 
    auto t0 = std::chrono::steady_clock::now();
 
-   // Recupera i risultati dalla device memory alla memoria host.
-   OCL_CHECK(ret,
-             clEnqueueReadBuffer(queue_, current_buffers.bufferC, CL_TRUE, 0,
-                                 required_size_bytes, task->c, 1, &previous_event, NULL),
-             return);
-
-   // Rilascia l'evento precedente.
-   if (previous_event)
-      clReleaseEvent(previous_event);
-   task->event = nullptr;
+   if (chunk_size_ > 0) {
+      get_chunk_results(task);
+   } else {
+      // Recupera i risultati dalla device memory alla memoria host.
+      OCL_CHECK(ret,
+                buffer_manager_->download_output(
+                   queues_, task->buffer_idx, task->c, required_size_bytes, previous_event,
+                   profile_events(task, DEVICE_D2H, config_.profile)),
+                return);
+
+      // Rilascia l'evento precedente.
+      if (previous_event)
+         clReleaseEvent(previous_event);
+      task->event = nullptr;
+   }
 
    // Calcola il tempo impiegato.
    auto t1 = std::chrono::steady_clock::now();
    computed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
 
+   // Con il profiling il tempo di calcolo è quello del kernel misurato sul device.
+   if (config_.profile) {
+      collect_device_times(task);
+      computed_ns = task->device_ns[DEVICE_KERNEL];
+   }
+
+   std::cerr << "[Fpga_Accelerator - END] Task " << task->id << " finished.\n";
+}
+
+/**
+ * @brief Stadio 3 (Download) asincrono. Accoda il download dei risultati dopo il kernel,
+ * senza attenderlo, e avvisa il nodo con una callback al suo completamento (vedi
+ * DownloadCompletion).
+ */
+void Fpga_Accelerator::start_results_download(void *task_context, CompletionFn on_complete,
+                                              void *user_data) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto *task = static_cast<Task *>(task_context);
+   size_t required_size_bytes = sizeof(int) * task->n;
+   cl_event done = nullptr;
+
+   auto t0 = std::chrono::steady_clock::now();
+
+   if (chunk_size_ > 0) {
+      // Un marker sulla coda di download segnala la fine delle letture di tutti i chunk. I
+      // sub-buffer vengono rilasciati in finish_results_download().
+      ret = enqueue_chunk_reads(task);
+      if (ret == CL_SUCCESS)
+         ret = clEnqueueMarkerWithWaitList(queues_.d2h,
+                                           static_cast<cl_uint>(task->chunk_events.size()),
+                                           task->chunk_events.data(), &done);
+      release_chunk_events(task);
+   } else {
+      ret = buffer_manager_->start_download_output(
+         queues_, task->buffer_idx, task->c, required_size_bytes, task->event, &done,
+         profile_events(task, DEVICE_D2H, config_.profile));
+      if (task->event)
+         clReleaseEvent(task->event);
+      task->event = nullptr;
+   }
+
+   if (ret != CL_SUCCESS) {
+      std::cerr << "[ERROR] Fpga_Accelerator: Failed to enqueue the download of task "
+                << task->id << " (code " << ret << ").\n";
+      DownloadCompletion::fail(task, on_complete, user_data);
+      return;
+   }
+
+   // Il download non è bloccante: senza flush potrebbe restare nella coda.
+   clFlush(queues_.d2h);
+   DownloadCompletion::notify(done, task, on_complete, user_data, t0);
+}
+
+/**
+ * @brief Completa un download asincrono terminato, sul thread Consumer.
+ */
+void Fpga_Accelerator::finish_results_download(void *task_context) {
+   auto *task = static_cast<Task *>(task_context);
+
+   // Con il profiling il tempo di calcolo è quello del kernel misurato sul device.
+   if (config_.profile) {
+      collect_device_times(task);
+      task->computed_ns = task->device_ns[DEVICE_KERNEL];
+   }
+
+   for (cl_mem sub_buffer : task->chunk_buffers)
+      clReleaseMemObject(sub_buffer);
+   task->chunk_buffers.clear();
+
    std::cerr << "[Fpga_Accelerator - END] Task " << task->id << " finished.\n";
 }
 
+// ------------------------------------------------------------------------
+// Esecuzione a chunk
+// ------------------------------------------------------------------------
+
+/**
+ * @brief Upload a chunk: crea i sub-buffer A, B e C di ogni chunk (usati come argomenti del
+ * kernel) e scrive A e B del chunk sulla coda di upload.
+ */
+void Fpga_Accelerator::send_chunks_to_device(Task *task, BufferManager::BufferSet &buffers) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto chunks = split_in_chunks(task->n, chunk_size_, chunk_align_elems_);
+   task->chunk_events.assign(chunks.size(), nullptr);
+   task->chunk_buffers.clear();
+
+   for (size_t k = 0; k < chunks.size(); ++k) {
+      cl_buffer_region region = {sizeof(int) * chunks[k].offset,
+                                 sizeof(int) * chunks[k].count};
+
+      // Flag 0: i sub-buffer ereditano i permessi dei buffer padre.
+      cl_mem parents[3] = {buffers.bufferA, buffers.bufferB, buffers.bufferC};
+      for (cl_mem parent : parents) {
+         cl_mem sub_buffer =
+            clCreateSubBuffer(parent, 0, CL_BUFFER_CREATE_TYPE_REGION, &region, &ret);
+         if (ret != CL_SUCCESS) {
+            std::cerr << "[ERROR] Fpga_Accelerator: Failed to create sub-buffer (code " << ret
+                      << ").\n";
+            release_chunk_events(task);
+            return;
+         }
+         task->chunk_buffers.push_back(sub_buffer);
+      }
+
+      cl_mem sub_a = task->chunk_buffers[3 * k];
+      cl_mem sub_b = task->chunk_buffers[3 * k + 1];
+      OCL_CHECK(ret,
+                queues_.write_inputs(sub_a, sub_b, 0, region.size, task->a + chunks[k].offset,
+                                     task->b + chunks[k].offset, &task->chunk_events[k],
+                                     profile_events(task, DEVICE_H2D, config_.profile)),
+                release_chunk_events(task);
+                return);
+   }
+
+   queues_.submit(queues_.h2d);
+}
+
+/**
+ * @brief Kernel a chunk: un clEnqueueTask per chunk sui suoi sub-buffer, in attesa del suo
+ * upload. Gli argomenti vengono copiati all'accodamento, quindi il kernel è riutilizzabile.
+ */
+void Fpga_Accelerator::execute_chunks(Task *task) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto chunks = split_in_chunks(task->n, chunk_size_, chunk_align_elems_);
+   if (task->chunk_events.size() != chunks.size())
+      return; // Upload fallito
+
+   for (size_t k = 0; k < chunks.size(); ++k) {
+      cl_event upload_event = task->chunk_events[k];
+      int count = static_cast<int>(chunks[k].count);
+
+      // Su un errore rilascia gli eventi dei chunk, compreso l'upload di quello corrente.
+      OCL_CHECK(ret, clSetKernelArg(kernel_, 0, sizeof(cl_mem), &task->chunk_buffers[3 * k]),
+                release_chunk_events(task);
+                return);
+      OCL_CHECK(ret,
+                clSetKernelArg(kernel_, 1, sizeof(cl_mem), &task->chunk_buffers[3 * k + 1]),
+                release_chunk_events(task);
+                return);
+      OCL_CHECK(ret,
+                clSetKernelArg(kernel_, 2, sizeof(cl_mem), &task->chunk_buffers[3 * k + 2]),
+                release_chunk_events(task);
+                return);
+      OCL_CHECK(ret, clSetKernelArg(kernel_, 3, sizeof(int), &count),
+                release_chunk_events(task);
+                return);
+
+      OCL_CHECK(ret,
+                clEnqueueTask(queues_.compute, kernel_, 1, &upload_event,
+                              &task->chunk_events[k]),
+                release_chunk_events(task);
+                return);
+      clReleaseEvent(upload_event);
+      keep_profile_event(profile_events(task, DEVICE_KERNEL, config_.profile),
+                         task->chunk_events[k]);
+   }
+
+   queues_.submit(queues_.compute);
+}
+
+/**
+ * @brief Download a chunk: accoda la lettura del sub-buffer C di ogni chunk dopo il suo
+ * kernel. L'evento di ogni lettura sostituisce quello del kernel in task->chunk_events.
+ */
+cl_int Fpga_Accelerator::enqueue_chunk_reads(Task *task) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto chunks = split_in_chunks(task->n, chunk_size_, chunk_align_elems_);
+   if (task->chunk_events.size() != chunks.size())
+      return CL_INVALID_EVENT_WAIT_LIST; // Upload o kernel falliti
+
+   for (size_t k = 0; k < chunks.size(); ++k) {
+      cl_event kernel_event = task->chunk_events[k];
+      OCL_CHECK(ret,
+                clEnqueueReadBuffer(queues_.d2h, task->chunk_buffers[3 * k + 2], CL_FALSE, 0,
+                                    sizeof(int) * chunks[k].count, task->c + chunks[k].offset,
+                                    1, &kernel_event, &task->chunk_events[k]),
+                release_chunk_events(task);
+                return ret);
+      clReleaseEvent(kernel_event);
+      keep_profile_event(profile_events(task, DEVICE_D2H, config_.profile),
+                         task->chunk_events[k]);
+   }
+   return CL_SUCCESS;
+}
+
+/**
+ * @brief Download a chunk bloccante: accoda le letture e le attende tutte (la coda può essere
+ * out-of-order). Rilascia poi eventi e sub-buffer del task.
+ */
+void Fpga_Accelerator::get_chunk_results(Task *task) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+
+   if (enqueue_chunk_reads(task) == CL_SUCCESS)
+      OCL_CHECK(ret,
+                clWaitForEvents(static_cast<cl_uint>(task->chunk_events.size()),
+                                task->chunk_events.data()),
+                (void)0);
+   release_chunk_events(task);
+   for (cl_mem sub_buffer : task->chunk_buffers)
+      clReleaseMemObject(sub_buffer);
+   task->chunk_buffers.clear();
+}
+
 // ------------------------------------------------------------------------
 // Metodi per l'acquisizione e il rilascio dei buffer
 // ------------------------------------------------------------------------
-size_t Fpga_Accelerator::acquire_buffer_set() { 
-   return buffer_manager_->acquire_buffer_set(); 
+size_t Fpga_Accelerator::acquire_buffer_set(size_t required_size_bytes) {
+   return buffer_manager_->acquire_buffer_set(required_size_bytes);
 }
 
 void Fpga_Accelerator::release_buffer_set(size_t index) {
    buffer_manager_->release_buffer_set(index);
+}
+
+void Fpga_Accelerator::report_stats(ComputeResult &res) {
+   add_device_name(res, device_name_);
+   if (buffer_manager_)
+      buffer_manager_->report_stats(res);
 }
\ No newline at end of file
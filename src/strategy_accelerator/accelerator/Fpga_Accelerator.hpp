@@ -1,6 +1,8 @@
 #pragma once
 
+#include "../../common/RunConfig.hpp"
 #include "BufferManager.hpp"
+#include "CommandQueues.hpp"
 #include "IAccelerator.hpp"
 #include <string>
 
@@ -18,10 +20,21 @@
  * funzioni qui dichiarate send_data_to_device() e execute_kernel().
  * - Il thread Consumer esegue lo stadio di Download, utilizzando la
  * funzione qui dichiarata get_results_from_device().
+ *
+ * Con RunConfig::chunk_size > 0 ogni task viene diviso in chunk. Il kernel HLS riceve
+ * puntatori e dimensione, quindi ogni chunk usa dei sub-buffer dei buffer del task; upload,
+ * kernel e download usano tre code di comandi distinte collegate dagli eventi dei chunk.
+ *
+ * Con RunConfig::cl_queue_mode out_of_order o split anche i task consecutivi vengono ordinati
+ * solo dagli eventi (vedi CommandQueues).
+ *
+ * Con RunConfig::completion = Callback il download viene accodato subito dopo il kernel e il
+ * task arriva al thread Consumer solo al completamento (vedi DownloadCompletion).
  */
 class Fpga_Accelerator : public IAccelerator {
  public:
-   Fpga_Accelerator(const std::string &kernel_path, const std::string &kernel_name);
+   Fpga_Accelerator(const std::string &kernel_path, const std::string &kernel_name,
+                    const RunConfig &config = RunConfig());
    ~Fpga_Accelerator() override;
 
    // Esegue tutte le operazioni di setup una volta sola (creare contesto,
@@ -32,16 +45,28 @@ class Fpga_Accelerator : public IAccelerator {
    void send_data_to_device(void *task_context) override;
    void execute_kernel(void *task_context) override;
    void get_results_from_device(void *task_context, long long &computed_ns) override;
+   void start_results_download(void *task_context, CompletionFn on_complete,
+                               void *user_data) override;
+   void finish_results_download(void *task_context) override;
 
    // Metodi per l'acquisizione e il rilascio dei buffer.
-   size_t acquire_buffer_set() override;
+   size_t acquire_buffer_set(size_t required_size_bytes) override;
    void release_buffer_set(size_t index) override;
 
+   // Nome del dispositivo e uso del pool di buffer.
+   void report_stats(ComputeResult &res) override;
+
  private:
-   cl_context context_{nullptr};     // Il contesto OpenCL
-   cl_command_queue queue_{nullptr}; // La coda di comandi OpenCL
-   cl_program program_{nullptr};     // Il programma OpenCL (kernel compilato)
-   cl_kernel kernel_{nullptr};       // Il kernel OpenCL (func da eseguire)
+   // Versioni a chunk dei tre stadi (RunConfig::chunk_size > 0).
+   void send_chunks_to_device(Task *task, BufferManager::BufferSet &buffers);
+   void execute_chunks(Task *task);
+   void get_chunk_results(Task *task);
+   cl_int enqueue_chunk_reads(Task *task);
+
+   cl_context context_{nullptr}; // Il contesto OpenCL
+   CommandQueues queues_;        // Le code di comandi OpenCL (upload, kernel, download)
+   cl_program program_{nullptr}; // Il programma OpenCL (kernel compilato)
+   cl_kernel kernel_{nullptr};   // Il kernel OpenCL (func da eseguire)
 
    // Incapsula la logica per l'acquisizione, il rilascio e la riallocazione dei
    // buffer di memoria sul device.
@@ -49,4 +74,10 @@ class Fpga_Accelerator : public IAccelerator {
 
    std::string kernel_path_;
    std::string kernel_name_;
+   std::string device_name_;     // CL_DEVICE_NAME della scheda
+   size_t chunk_size_;          // Elementi per chunk, 0 = task intero
+   size_t chunk_align_elems_{1}; // Allineamento dell'origine dei sub-buffer, in elementi
+   ClQueueMode queue_mode_;      // Code di comandi richieste
+   MemMode mem_mode_;            // Memoria dell'host per i trasferimenti
+   RunConfig config_;            // Opzioni di esecuzione (per il pool di buffer)
 };
\ No newline at end of file
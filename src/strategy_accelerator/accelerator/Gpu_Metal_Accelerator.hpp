@@ -25,9 +25,12 @@ class Gpu_Metal_Accelerator : public IAccelerator {
    void get_results_from_device(void *task_context, long long &computed_ns) override;
 
    // Metodi per l'acquisizione e il rilascio dei buffer.
-   size_t acquire_buffer_set() override;
+   size_t acquire_buffer_set(size_t required_size_bytes) override;
    void release_buffer_set(size_t index) override;
 
+   // Nome del dispositivo.
+   void report_stats(ComputeResult &res) override;
+
  private:
    // --- Oggetti Metal ---
    void *device_{nullptr};          // Puntatore al device Metal (id<MTLDevice>).
@@ -41,4 +44,5 @@ class Gpu_Metal_Accelerator : public IAccelerator {
 
    std::string kernel_path_;
    std::string kernel_name_;
+   std::string device_name_; // Nome del device Metal
 };
\ No newline at end of file
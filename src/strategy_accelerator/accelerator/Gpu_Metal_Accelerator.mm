@@ -24,11 +24,12 @@
 // =======================================================================
 class MetalBufferManager {
  public:
-   // Set di buffer, 2 per input e 1 per l'output.
+   // Set di buffer, 2 per input e 1 per l'output, allocati per bytes byte ciascuno.
    struct BufferSet {
       id<MTLBuffer> bufferA{nullptr};
       id<MTLBuffer> bufferB{nullptr};
       id<MTLBuffer> bufferC{nullptr};
+      size_t bytes{0};
    };
 
    /**
@@ -46,16 +47,25 @@ class MetalBufferManager {
    /**
     * Acquisisce un indice di buffer dal pool. Se nessun buffer è
     * disponibile per un thread da acquisire, attende in modo non bloccante.
+    * I buffer di un set più piccolo del task vengono ingranditi: il set non è usato da nessun
+    * altro task, mentre gli altri set possono essere in volo (--mixed-n, batching).
     */
-   size_t acquire_buffer_set() {
-      std::unique_lock<std::mutex> lock(pool_mutex_);
+   size_t acquire_buffer_set(size_t required_size_bytes) {
+      size_t index;
+      {
+         std::unique_lock<std::mutex> lock(pool_mutex_);
+
+         // Attende finché non c'è un buffer libero.
+         buffer_available_cond_.wait(lock, [this] { return !free_buffer_indices_.empty(); });
 
-      // Attende finché non c'è un buffer libero.
-      buffer_available_cond_.wait(lock, [this] { return !free_buffer_indices_.empty(); });
+         // Th risvegliato. Estrae l'indice del buffer libero.
+         index = free_buffer_indices_.front();
+         free_buffer_indices_.pop();
+      }
 
-      // Th risvegliato. Estrae e restituisce l'indice del buffer libero.
-      size_t index = free_buffer_indices_.front();
-      free_buffer_indices_.pop();
+      BufferSet &set = buffer_pool_[index];
+      if (set.bytes < required_size_bytes && !allocate_buffer_set(set, required_size_bytes))
+         exit(EXIT_FAILURE);
       return index;
    }
 
@@ -70,38 +80,33 @@ class MetalBufferManager {
       buffer_available_cond_.notify_one();
    }
 
-   bool reallocate_buffers_if_needed(size_t required_size_bytes) {
-      if (allocated_size_bytes_ == required_size_bytes)
-         return true;
+   BufferSet &get_buffer_set(size_t index) { return buffer_pool_[index]; }
 
-      allocated_size_bytes_ = required_size_bytes;
+ private:
+   /**
+    * Alloca i buffer di un solo set per required_size_bytes byte. ARC rilascia i buffer
+    * precedenti del set.
+    */
+   bool allocate_buffer_set(BufferSet &set, size_t required_size_bytes) {
       // Su Apple Silicon la memoria è condivisa tra CPU e GPU, quindi possiamo accedere agli
       // stessi dati senza copie esplicite sul bus PCIe.
       MTLResourceOptions options = MTLResourceStorageModeShared;
 
-      for (size_t i = 0; i < POOL_SIZE; ++i) {
-         buffer_pool_[i].bufferA = [device_ newBufferWithLength:required_size_bytes
-                                                        options:options];
-         buffer_pool_[i].bufferB = [device_ newBufferWithLength:required_size_bytes
-                                                        options:options];
-         buffer_pool_[i].bufferC = [device_ newBufferWithLength:required_size_bytes
-                                                        options:options];
-         if (!buffer_pool_[i].bufferA || !buffer_pool_[i].bufferB ||
-             !buffer_pool_[i].bufferC) {
-            std::cerr << "[ERROR] MetalBufferManager: Failed to allocate "
-                         "buffer pool.\n";
-            return false;
-         }
+      set.bufferA = [device_ newBufferWithLength:required_size_bytes options:options];
+      set.bufferB = [device_ newBufferWithLength:required_size_bytes options:options];
+      set.bufferC = [device_ newBufferWithLength:required_size_bytes options:options];
+      if (!set.bufferA || !set.bufferB || !set.bufferC) {
+         std::cerr << "[ERROR] MetalBufferManager: Failed to allocate "
+                      "buffer pool.\n";
+         return false;
       }
-      std::cerr << "  [MetalBufferManager - DEBUG] Allocating pool buffers for "
+      set.bytes = required_size_bytes;
+      std::cerr << "  [MetalBufferManager - DEBUG] Allocating buffer set for "
                 << required_size_bytes << " bytes\n";
 
       return true;
    }
 
-   BufferSet &get_buffer_set(size_t index) { return buffer_pool_[index]; }
-
- private:
    id<MTLDevice> device_; // Riferimento al device Metal.
 
    // Dati per il pool di buffer nel device e per la gestione della concorrenza.
@@ -110,9 +115,6 @@ class MetalBufferManager {
    std::queue<size_t> free_buffer_indices_;
    std::mutex pool_mutex_;
    std::condition_variable buffer_available_cond_;
-
-   // Dimensione attualmente allocata per i buffer nel pool.
-   size_t allocated_size_bytes_{0};
 };
 
 // =======================================================================
@@ -158,6 +160,7 @@ bool Gpu_Metal_Accelerator::initialize() {
 
    // Crea la coda di comandi.
    id<MTLDevice> dev = (__bridge id<MTLDevice>)device_;
+   device_name_ = [[dev name] UTF8String];
    command_queue_ = (__bridge_retained void *)[dev newCommandQueue];
    if (!command_queue_) {
       std::cerr << "[ERROR] Gpu_Metal_Accelerator: Failed to create command queue.\n";
@@ -230,10 +233,8 @@ void Gpu_Metal_Accelerator::send_data_to_device(void *task_context) {
    std::cerr << "[Gpu_Metal_Accelerator - START] Processing task " << task->id
              << " with N=" << task->n << "...\n";
 
-   // Se la dimensione richiesta è diversa da quella allocata, rialloca tutti i buffer del pool
-   // e ottieni il set di buffer.
+   // Il set acquisito è già grande almeno quanto il task (vedi acquire_buffer_set).
    size_t required_size_bytes = sizeof(int) * task->n;
-   buffer_manager_->reallocate_buffers_if_needed(required_size_bytes);
    auto &current_buffers = buffer_manager_->get_buffer_set(task->buffer_idx);
 
    // Grazie alla memoria unificata, copia i dati direttamente.
@@ -317,10 +318,14 @@ void Gpu_Metal_Accelerator::get_results_from_device(void *task_context,
 // ------------------------------------------------------------------------
 // Metodi per l'acquisizione e il rilascio dei buffer
 // ------------------------------------------------------------------------
-size_t Gpu_Metal_Accelerator::acquire_buffer_set() {
-   return buffer_manager_->acquire_buffer_set();
+size_t Gpu_Metal_Accelerator::acquire_buffer_set(size_t required_size_bytes) {
+   return buffer_manager_->acquire_buffer_set(required_size_bytes);
 }
 
 void Gpu_Metal_Accelerator::release_buffer_set(size_t index) {
    buffer_manager_->release_buffer_set(index);
-}
\ No newline at end of file
+}
+
+void Gpu_Metal_Accelerator::report_stats(ComputeResult &res) {
+   add_device_name(res, device_name_);
+}
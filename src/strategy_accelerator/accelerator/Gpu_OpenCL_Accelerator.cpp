@@ -1,4 +1,8 @@
 #include "Gpu_OpenCL_Accelerator.hpp"
+#include "Chunking.hpp"
+#include "DownloadCompletion.hpp"
+#include "Profiling.hpp"
+#include "ProgramCache.hpp"
 
 #include <chrono>
 #include <filesystem>
@@ -23,63 +27,168 @@
    } while (0)
 
 /**
- * @brief Il costruttrore prende in input il nome della funzione kernel e il suo path.
+ * @brief Il costruttrore prende in input il nome della funzione kernel e il suo path, l'indice
+ * e il tipo del dispositivo da usare e le opzioni di esecuzione (dimensione dei chunk, code
+ * di comandi e modalità di memoria). 'shared' è il contesto del dispositivo condiviso con gli
+ * altri worker della farm, nullptr = contesto proprio.
  */
 Gpu_OpenCL_Accelerator::Gpu_OpenCL_Accelerator(const std::string &kernel_path,
-                                               const std::string &kernel_name)
-    : kernel_path_(kernel_path), kernel_name_(kernel_name) {}
+                                               const std::string &kernel_name,
+                                               size_t device_index, cl_device_type device_type,
+                                               const RunConfig &config,
+                                               std::shared_ptr<OpenClDeviceContext> shared)
+    : shared_(shared ? std::move(shared) : std::make_shared<OpenClDeviceContext>()),
+      kernel_path_(kernel_path), kernel_name_(kernel_name), device_index_(device_index),
+      device_type_(device_type), chunk_size_(config.chunk_size),
+      queue_mode_(config.cl_queue_mode), mem_mode_(config.mem_mode),
+      config_(config) {}
 
 /**
  * @brief Il distruttore si occupa di rilasciare in ordine inverso tutte le risorse OpenCL
- * allocate. La pulizia dei buffer è gestita automaticamente dal distruttore di
- * buffer_manager_.
+ * allocate. La pulizia dei buffer è gestita dal distruttore di buffer_manager_, chiamato per
+ * primo perché con la memoria pinned usa la coda di comandi. Contesto e programma vengono
+ * rilasciati dall'ultimo acceleratore che li condivide (OpenClDeviceContext).
  */
 Gpu_OpenCL_Accelerator::~Gpu_OpenCL_Accelerator() {
+   buffer_manager_.reset();
    if (kernel_)
       clReleaseKernel(kernel_);
-   if (program_)
-      clReleaseProgram(program_);
-   if (queue_)
-      clReleaseCommandQueue(queue_);
-   if (context_)
-      clReleaseContext(context_);
+   queues_.release();
+   shared_.reset();
 
    std::cerr << "[Gpu_OpenCL_Accelerator] Destroyed and resources released.\n";
 }
 
+// Nome del tipo di dispositivo OpenCL per i log, come in --cl-device-type.
+static const char *device_type_name(cl_device_type device_type) {
+   switch (device_type) {
+   case CL_DEVICE_TYPE_CPU:
+      return "cpu";
+   case CL_DEVICE_TYPE_ACCELERATOR:
+      return "accelerator";
+   case CL_DEVICE_TYPE_ALL:
+      return "all";
+   default:
+      return "gpu";
+   }
+}
+
+/**
+ * @brief Elenca i dispositivi del tipo richiesto su tutte le piattaforme OpenCL disponibili.
+ * Le piattaforme che non hanno dispositivi di quel tipo vengono ignorate.
+ */
+std::vector<cl_device_id> Gpu_OpenCL_Accelerator::list_devices(cl_device_type device_type) {
+   std::vector<cl_device_id> devices;
+
+   cl_uint num_platforms = 0;
+   if (clGetPlatformIDs(0, NULL, &num_platforms) != CL_SUCCESS || num_platforms == 0)
+      return devices;
+   std::vector<cl_platform_id> platforms(num_platforms);
+   if (clGetPlatformIDs(num_platforms, platforms.data(), NULL) != CL_SUCCESS)
+      return devices;
+
+   for (cl_platform_id platform : platforms) {
+      cl_uint num_devices = 0;
+      if (clGetDeviceIDs(platform, device_type, 0, NULL, &num_devices) != CL_SUCCESS ||
+          num_devices == 0)
+         continue;
+
+      std::vector<cl_device_id> platform_devices(num_devices);
+      if (clGetDeviceIDs(platform, device_type, num_devices, platform_devices.data(), NULL) ==
+          CL_SUCCESS)
+         devices.insert(devices.end(), platform_devices.begin(), platform_devices.end());
+   }
+
+   return devices;
+}
+
 /**
  * @brief Esegue tutte le operazioni di setup una volta sola. Trova il dispositivo, crea il
- * contesto, la coda di comandi, legge il sorgente del kernel, lo compila e prepara l'oggetto
- * kernel, inizializza il pool di buffer e la coda degli indici liberi.
+ * contesto e compila il programma (o li prende dal worker che li ha già creati), crea le code
+ * di comandi e l'oggetto kernel, inizializza il pool di buffer e la coda degli indici liberi.
  */
 bool Gpu_OpenCL_Accelerator::initialize() {
    cl_int ret; // Codice di ritorno delle chiamate OpenCL
-   cl_platform_id platform_id = NULL;
-   cl_device_id device_id = NULL;
-
-   // Trova una piattaforma OpenCL e un dispositivo di tipo GPU.
-   OCL_CHECK(ret, clGetPlatformIDs(1, &platform_id, NULL), return false);
-   OCL_CHECK(ret, clGetDeviceIDs(platform_id, CL_DEVICE_TYPE_GPU, 1, &device_id, NULL), {
-      std::cerr << "[FATAL] GPU not found.\n";
-      exit(EXIT_FAILURE);
-   });
 
-   // Crea un contesto OpenCL.
-   context_ = clCreateContext(NULL, 1, &device_id, NULL, NULL, &ret);
-   if (!context_ || ret != CL_SUCCESS) {
-      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to create OpenCL context.\n";
+   // Trova i dispositivi del tipo richiesto (di default GPU) e sceglie quello con l'indice
+   // assegnato a questa istanza.
+   std::vector<cl_device_id> devices = list_devices(device_type_);
+   if (devices.empty()) {
+      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: No OpenCL device of type '"
+                << device_type_name(device_type_) << "' found.\n";
+      return false;
+   }
+   if (device_index_ >= devices.size()) {
+      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Device index " << device_index_
+                << " out of range (" << devices.size() << " devices found).\n";
       return false;
    }
+   cl_device_id device_id = devices[device_index_];
+
+   char device_name[256] = {0};
+   clGetDeviceInfo(device_id, CL_DEVICE_NAME, sizeof(device_name) - 1, device_name, NULL);
+   std::cerr << "[Gpu_OpenCL_Accelerator] Using device " << device_index_ << ": "
+             << device_name << "\n";
+   device_name_ = device_name;
+
+   // Contesto e programma del dispositivo: li crea il primo worker che si inizializza.
+   {
+      std::lock_guard<std::mutex> lock(shared_->mutex);
+      if (!shared_->context && !create_context_and_program(device_id))
+         return false;
+      context_ = shared_->context;
+      program_ = shared_->program;
+   }
 
-   // Crea la coda di comandi.
-   queue_ = clCreateCommandQueue(context_, device_id, 0, &ret);
-   if (!queue_ || ret != CL_SUCCESS) {
-      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to create command queue.\n";
+   // L'esecuzione a chunk trasferisce sottointervalli dei buffer, quindi usa solo la memoria
+   // in modalità copy.
+   if (chunk_size_ > 0 && mem_mode_ != MemMode::Copy) {
+      std::cerr << "[WARNING] Gpu_OpenCL_Accelerator: Chunked execution requires --mem=copy, "
+                   "running whole tasks.\n";
+      chunk_size_ = 0;
+   }
+
+   // Crea le code di comandi. L'esecuzione a chunk usa sempre code separate per upload e
+   // download.
+   if (!queues_.create(context_, device_id, queue_mode_, chunk_size_ > 0, config_.profile,
+                       "Gpu_OpenCL_Accelerator"))
       return false;
+
+   if (chunk_size_ > 0) {
+      std::cerr << "[Gpu_OpenCL_Accelerator] Chunked execution: " << chunk_size_
+                << " elements per chunk.\n";
    }
 
-   // Chiama il costruttore di BufferManager che iniializza il pool di buffer.
-   buffer_manager_ = std::make_unique<BufferManager>(context_);
+   // Chiama il costruttore di BufferManager che iniializza il pool di buffer, con la sua quota
+   // della memoria del dispositivo.
+   buffer_manager_ = std::make_unique<BufferManager>(context_, device_id, queues_.compute,
+                                                     config_, shared_->workers);
+
+   // Crea l'oggetto kernel, proprio di ogni worker: gli argomenti vengono impostati per task.
+   kernel_ = clCreateKernel(program_, kernel_name_.c_str(), &ret);
+   if (!kernel_ || ret != CL_SUCCESS) {
+      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to create kernel object.\n";
+      exit(EXIT_FAILURE);
+   }
+
+   std::cerr << "[Gpu_OpenCL_Accelerator] Initialization successful.\n";
+   return true;
+}
+
+/**
+ * @brief Crea il contesto del dispositivo, legge il sorgente del kernel e lo compila (o lo
+ * carica dalla cache), salvandoli nel contesto condiviso. Chiamata con shared_->mutex
+ * acquisito. In caso di errore rilascia il contesto e lascia vuoto quello condiviso.
+ */
+bool Gpu_OpenCL_Accelerator::create_context_and_program(cl_device_id device_id) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+
+   // Crea un contesto OpenCL.
+   cl_context context = clCreateContext(NULL, 1, &device_id, NULL, NULL, &ret);
+   if (!context || ret != CL_SUCCESS) {
+      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to create OpenCL context.\n";
+      return false;
+   }
 
    // Legge il kernel OpenCL e verifica che il percorso sia un file valido.
    std::ifstream kernelFile(kernel_path_);
@@ -90,49 +199,35 @@ bool Gpu_OpenCL_Accelerator::initialize() {
        kernel_path_.rfind(".cl") == std::string::npos) {
       std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Could not open kernel file: "
                 << kernel_path_ << "\n";
-      exit(EXIT_FAILURE);
+      clReleaseContext(context);
+      return false;
    }
    std::string kernelSource((std::istreambuf_iterator<char>(kernelFile)),
                             (std::istreambuf_iterator<char>()));
-   const char *source_str = kernelSource.c_str();
-   size_t source_size = kernelSource.length();
-
-   // Crea il programma OpenCL.
-   program_ = clCreateProgramWithSource(context_, 1, &source_str, &source_size, &ret);
-   if (!program_ || ret != CL_SUCCESS) {
-      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to create program.\n";
-      exit(EXIT_FAILURE);
-   }
-
-   // Compila il programma OpenCL.
-   ret = clBuildProgram(program_, 1, &device_id, NULL, NULL, NULL);
-   if (ret != CL_SUCCESS) {
-      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Kernel "
-                   "compilation failed.\n";
-      size_t log_size;
-      clGetProgramBuildInfo(program_, device_id, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
-      std::vector<char> log(log_size);
-      clGetProgramBuildInfo(program_, device_id, CL_PROGRAM_BUILD_LOG, log_size, log.data(),
-                            NULL);
-      exit(EXIT_FAILURE);
-   }
 
-   // Crea l'oggetto kernel.
-   kernel_ = clCreateKernel(program_, kernel_name_.c_str(), &ret);
-   if (!kernel_ || ret != CL_SUCCESS) {
-      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to create kernel object.\n";
-      exit(EXIT_FAILURE);
+   // Crea e compila il programma OpenCL, usando i binari in cache se disponibili.
+   ProgramBuild build = build_program(context, device_id, kernelSource, "",
+                                      config_.kernel_cache_dir, "Gpu_OpenCL_Accelerator");
+   if (!build.program) {
+      clReleaseContext(context);
+      return false;
    }
 
-   std::cerr << "[Gpu_OpenCL_Accelerator] Initialization successful.\n";
+   // Il contesto condiviso viene pubblicato solo con il programma: un errore non lascia ai
+   // worker successivi un contesto senza programma.
+   shared_->context = context;
+   shared_->program = build.program;
+   program_built_ = true;
+   program_cached_ = build.from_cache;
+   program_build_ns_ = build.build_ns;
    return true;
 }
 
 /**
  * @brief Stadio 1 (Upload).
- * Fa l'upload dei dati di input A e B dall'host alla device memory. L' evento per la
- * sincronizzazione (`task->event`) viene generato solodall'ultima operazione, garantendo che
- * lo stadio successivo attenda ilcompletamento di entrambi i trasferimenti.
+ * Fa l'upload dei dati di input A e B dall'host alla device memory. L'evento per la
+ * sincronizzazione (`task->event`) segnala il completamento di entrambi i trasferimenti
+ * (anche su una coda out-of-order), garantendo che lo stadio successivo li attenda.
  */
 void Gpu_OpenCL_Accelerator::send_data_to_device(void *task_context) {
    cl_int ret; // Codice di ritorno delle chiamate OpenCL
@@ -141,21 +236,22 @@ void Gpu_OpenCL_Accelerator::send_data_to_device(void *task_context) {
    std::cerr << "[Gpu_OpenCL_Accelerator - START] Processing task " << task->id
              << " with N=" << task->n << "...\n";
 
-   // Se la dimensione richiesta è diversa da quella allocata, rialloca
-   // tutti i buffer del pool e ottieni il set di buffer.
+   // Il set di buffer acquisito per il task ha buffer di almeno N elementi.
    size_t required_size_bytes = sizeof(int) * task->n;
-   buffer_manager_->reallocate_buffers_if_needed(required_size_bytes);
    auto &current_buffers = buffer_manager_->get_buffer_set(task->buffer_idx);
 
-   // Scrive i due input sulla device memory.
-   OCL_CHECK(ret,
-             clEnqueueWriteBuffer(queue_, current_buffers.bufferA, CL_FALSE, 0,
-                                  required_size_bytes, task->a, 0, NULL, NULL),
-             return);
+   if (chunk_size_ > 0) {
+      send_chunks_to_device(task, current_buffers);
+      return;
+   }
+
+   // Scrive i due input sulla device memory (o li rende visibili al device, con zero-copy).
    OCL_CHECK(ret,
-             clEnqueueWriteBuffer(queue_, current_buffers.bufferB, CL_FALSE, 0,
-                                  required_size_bytes, task->b, 0, NULL, &task->event),
+             buffer_manager_->upload_inputs(queues_, task->buffer_idx, task->a, task->b,
+                                            task->c, required_size_bytes, &task->event,
+                                            profile_events(task, DEVICE_H2D, config_.profile)),
              return);
+   queues_.submit(queues_.h2d);
 }
 
 /**
@@ -179,12 +275,19 @@ void Gpu_OpenCL_Accelerator::execute_kernel(void *task_context) {
              return);
    OCL_CHECK(ret, clSetKernelArg(kernel_, 3, sizeof(unsigned int), &(task->n)), return);
 
+   if (chunk_size_ > 0) {
+      execute_chunks(task);
+      return;
+   }
+
    // Accoda l'esecuzione del kernel.
    size_t global_work_size = task->n;
    OCL_CHECK(ret,
-             clEnqueueNDRangeKernel(queue_, kernel_, 1, NULL, &global_work_size, NULL, 1,
-                                    &previous_event, &task->event),
+             clEnqueueNDRangeKernel(queues_.compute, kernel_, 1, NULL, &global_work_size,
+                                    NULL, 1, &previous_event, &task->event),
              return);
+   keep_profile_event(profile_events(task, DEVICE_KERNEL, config_.profile), task->event);
+   queues_.submit(queues_.compute);
 
    // Rilascia l'evento precedente.
    if (previous_event)
@@ -207,31 +310,212 @@ void Gpu_OpenCL_Accelerator::get_results_from_device(void *task_context,
 
    auto t0 = std::chrono::steady_clock::now();
 
-   // Recupera i risultati dalla device memory alla memoria host.
-   OCL_CHECK(ret,
-             clEnqueueReadBuffer(queue_, current_buffers.bufferC, CL_TRUE, 0,
-                                 required_size_bytes, task->c, 1, &previous_event, NULL),
-             return);
-
-   // Rilascia l'evento precedente.
-   if (previous_event)
-      clReleaseEvent(previous_event);
-   task->event = nullptr;
+   if (chunk_size_ > 0) {
+      get_chunk_results(task, current_buffers);
+   } else {
+      // Recupera i risultati dalla device memory alla memoria host.
+      OCL_CHECK(ret,
+                buffer_manager_->download_output(
+                   queues_, task->buffer_idx, task->c, required_size_bytes, previous_event,
+                   profile_events(task, DEVICE_D2H, config_.profile)),
+                return);
+
+      // Rilascia l'evento precedente.
+      if (previous_event)
+         clReleaseEvent(previous_event);
+      task->event = nullptr;
+   }
 
    // Calcola il tempo impiegato
    auto t1 = std::chrono::steady_clock::now();
    computed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
 
+   // Con il profiling il tempo di calcolo è quello del kernel misurato sul device.
+   if (config_.profile) {
+      collect_device_times(task);
+      computed_ns = task->device_ns[DEVICE_KERNEL];
+   }
+
    std::cerr << "[Gpu_OpenCL_Accelerator - END] Task " << task->id << " finished.\n";
 }
 
+/**
+ * @brief Stadio 3 (Download) asincrono. Accoda il download dei risultati dopo il kernel,
+ * senza attenderlo, e avvisa il nodo con una callback al suo completamento (vedi
+ * DownloadCompletion).
+ */
+void Gpu_OpenCL_Accelerator::start_results_download(void *task_context,
+                                                    CompletionFn on_complete,
+                                                    void *user_data) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto *task = static_cast<Task *>(task_context);
+   size_t required_size_bytes = sizeof(int) * task->n;
+   cl_event done = nullptr;
+
+   auto t0 = std::chrono::steady_clock::now();
+
+   if (chunk_size_ > 0) {
+      // Un marker sulla coda di download segnala la fine delle letture di tutti i chunk.
+      auto &current_buffers = buffer_manager_->get_buffer_set(task->buffer_idx);
+      ret = enqueue_chunk_reads(task, current_buffers);
+      if (ret == CL_SUCCESS)
+         ret = clEnqueueMarkerWithWaitList(queues_.d2h,
+                                           static_cast<cl_uint>(task->chunk_events.size()),
+                                           task->chunk_events.data(), &done);
+      release_chunk_events(task);
+   } else {
+      ret = buffer_manager_->start_download_output(
+         queues_, task->buffer_idx, task->c, required_size_bytes, task->event, &done,
+         profile_events(task, DEVICE_D2H, config_.profile));
+      if (task->event)
+         clReleaseEvent(task->event);
+      task->event = nullptr;
+   }
+
+   if (ret != CL_SUCCESS) {
+      std::cerr << "[ERROR] Gpu_OpenCL_Accelerator: Failed to enqueue the download of task "
+                << task->id << " (code " << ret << ").\n";
+      DownloadCompletion::fail(task, on_complete, user_data);
+      return;
+   }
+
+   // Il download non è bloccante: senza flush potrebbe restare nella coda.
+   clFlush(queues_.d2h);
+   DownloadCompletion::notify(done, task, on_complete, user_data, t0);
+}
+
+/**
+ * @brief Completa un download asincrono terminato, sul thread Consumer.
+ */
+void Gpu_OpenCL_Accelerator::finish_results_download(void *task_context) {
+   auto *task = static_cast<Task *>(task_context);
+
+   // Con il profiling il tempo di calcolo è quello del kernel misurato sul device.
+   if (config_.profile) {
+      collect_device_times(task);
+      task->computed_ns = task->device_ns[DEVICE_KERNEL];
+   }
+
+   std::cerr << "[Gpu_OpenCL_Accelerator - END] Task " << task->id << " finished.\n";
+}
+
+// ------------------------------------------------------------------------
+// Esecuzione a chunk
+// ------------------------------------------------------------------------
+
+/**
+ * @brief Upload a chunk: scrive A e B di ogni chunk sulla coda di upload, all'offset del
+ * chunk. L'evento del chunk segnala che entrambi gli input sono sul device.
+ */
+void Gpu_OpenCL_Accelerator::send_chunks_to_device(Task *task,
+                                                   BufferManager::BufferSet &buffers) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto chunks = split_in_chunks(task->n, chunk_size_);
+   task->chunk_events.assign(chunks.size(), nullptr);
+
+   for (size_t k = 0; k < chunks.size(); ++k) {
+      size_t offset_bytes = sizeof(int) * chunks[k].offset;
+      size_t size_bytes = sizeof(int) * chunks[k].count;
+
+      OCL_CHECK(ret,
+                queues_.write_inputs(buffers.bufferA, buffers.bufferB, offset_bytes,
+                                     size_bytes, task->a + chunks[k].offset,
+                                     task->b + chunks[k].offset, &task->chunk_events[k],
+                                     profile_events(task, DEVICE_H2D, config_.profile)),
+                release_chunk_events(task);
+                return);
+   }
+
+   // Avvia subito i trasferimenti, senza attendere il flush implicito della coda.
+   queues_.submit(queues_.h2d);
+}
+
+/**
+ * @brief Kernel a chunk: un NDRange per chunk con global work offset pari all'offset del chunk
+ * (gli argomenti del kernel sono i buffer interi e N), in attesa del suo upload.
+ */
+void Gpu_OpenCL_Accelerator::execute_chunks(Task *task) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto chunks = split_in_chunks(task->n, chunk_size_);
+   if (task->chunk_events.size() != chunks.size())
+      return; // Upload fallito
+
+   for (size_t k = 0; k < chunks.size(); ++k) {
+      cl_event upload_event = task->chunk_events[k];
+      size_t global_work_offset = chunks[k].offset;
+      size_t global_work_size = chunks[k].count;
+
+      OCL_CHECK(ret,
+                clEnqueueNDRangeKernel(queues_.compute, kernel_, 1, &global_work_offset,
+                                       &global_work_size, NULL, 1, &upload_event,
+                                       &task->chunk_events[k]),
+                release_chunk_events(task);
+                return);
+      clReleaseEvent(upload_event);
+      keep_profile_event(profile_events(task, DEVICE_KERNEL, config_.profile),
+                         task->chunk_events[k]);
+   }
+
+   queues_.submit(queues_.compute);
+}
+
+/**
+ * @brief Download a chunk: accoda la lettura di C di ogni chunk sulla coda di download dopo il
+ * suo kernel. L'evento di ogni lettura sostituisce quello del kernel in task->chunk_events.
+ */
+cl_int Gpu_OpenCL_Accelerator::enqueue_chunk_reads(Task *task,
+                                                   BufferManager::BufferSet &buffers) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+   auto chunks = split_in_chunks(task->n, chunk_size_);
+   if (task->chunk_events.size() != chunks.size())
+      return CL_INVALID_EVENT_WAIT_LIST; // Upload o kernel falliti
+
+   for (size_t k = 0; k < chunks.size(); ++k) {
+      cl_event kernel_event = task->chunk_events[k];
+      OCL_CHECK(ret,
+                clEnqueueReadBuffer(queues_.d2h, buffers.bufferC, CL_FALSE,
+                                    sizeof(int) * chunks[k].offset,
+                                    sizeof(int) * chunks[k].count, task->c + chunks[k].offset,
+                                    1, &kernel_event, &task->chunk_events[k]),
+                release_chunk_events(task);
+                return ret);
+      clReleaseEvent(kernel_event);
+      keep_profile_event(profile_events(task, DEVICE_D2H, config_.profile),
+                         task->chunk_events[k]);
+   }
+   return CL_SUCCESS;
+}
+
+/**
+ * @brief Download a chunk bloccante: accoda le letture e le attende tutte (la coda può essere
+ * out-of-order, quindi non basta l'ultima).
+ */
+void Gpu_OpenCL_Accelerator::get_chunk_results(Task *task, BufferManager::BufferSet &buffers) {
+   cl_int ret; // Codice di ritorno delle chiamate OpenCL
+
+   if (enqueue_chunk_reads(task, buffers) == CL_SUCCESS)
+      OCL_CHECK(ret,
+                clWaitForEvents(static_cast<cl_uint>(task->chunk_events.size()),
+                                task->chunk_events.data()),
+                (void)0);
+   release_chunk_events(task);
+}
+
 // ------------------------------------------------------------------------
 // Metodi per l'acquisizione e il rilascio dei buffer
 // ------------------------------------------------------------------------
-size_t Gpu_OpenCL_Accelerator::acquire_buffer_set() {
-   return buffer_manager_->acquire_buffer_set();
+size_t Gpu_OpenCL_Accelerator::acquire_buffer_set(size_t required_size_bytes) {
+   return buffer_manager_->acquire_buffer_set(required_size_bytes);
 }
 
 void Gpu_OpenCL_Accelerator::release_buffer_set(size_t index) {
    buffer_manager_->release_buffer_set(index);
+}
+
+void Gpu_OpenCL_Accelerator::report_stats(ComputeResult &res) {
+   add_device_name(res, device_name_);
+   if (program_built_)
+      add_program_build(res, program_cached_, program_build_ns_);
+   if (buffer_manager_)
+      buffer_manager_->report_stats(res);
 }
\ No newline at end of file
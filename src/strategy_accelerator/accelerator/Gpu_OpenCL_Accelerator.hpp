@@ -1,8 +1,13 @@
 #pragma once
 
+#include "../../common/RunConfig.hpp"
 #include "BufferManager.hpp"
+#include "CommandQueues.hpp"
 #include "IAccelerator.hpp"
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenCL/opencl.h>
@@ -10,6 +15,26 @@
 #include <CL/cl.h>
 #endif
 
+/**
+ * @brief Contesto e programma OpenCL di un dispositivo, condivisi dagli acceleratori di una
+ * farm che lo usano: il primo che si inizializza li crea, gli altri li riusano. Ogni
+ * acceleratore ha comunque le proprie code di comandi, il proprio kernel e il proprio pool di
+ * buffer, con 1/workers del budget di memoria del dispositivo.
+ */
+struct OpenClDeviceContext {
+   std::mutex mutex;             // Serializza la creazione fra gli acceleratori
+   cl_context context{nullptr};
+   cl_program program{nullptr};
+   size_t workers{1};            // Acceleratori che usano il dispositivo
+
+   ~OpenClDeviceContext() {
+      if (program)
+         clReleaseProgram(program);
+      if (context)
+         clReleaseContext(context);
+   }
+};
+
 /**
  * @brief Implementazione di IAccelerator che gestisce l'offloading su GPU.
  *
@@ -18,12 +43,39 @@
  * dichiarate send_data_to_device() e execute_kernel().
  * - Il thread Consumer esegue lo stadio di Download, utilizzando la funzione qui dichiarata
  * get_results_from_device().
+ *
+ * Il dispositivo viene scelto per indice fra tutti quelli del tipo richiesto su tutte le
+ * piattaforme OpenCL, così una farm può creare un'istanza per dispositivo. Più istanze sullo
+ * stesso dispositivo condividono contesto e programma (OpenClDeviceContext), ognuna con le
+ * proprie code di comandi.
+ *
+ * Con RunConfig::chunk_size > 0 ogni task viene diviso in chunk, usando gli offset dei buffer
+ * e del global work. Upload, kernel e download usano tre code di comandi in-order distinte,
+ * collegate dagli eventi di ogni chunk, così i trasferimenti di un chunk si sovrappongono al
+ * calcolo degli altri anche all'interno dello stesso task.
+ *
+ * Con RunConfig::cl_queue_mode out_of_order o split gli stadi dei task consecutivi vengono
+ * ordinati solo dagli eventi (vedi CommandQueues), così l'upload di un task si sovrappone al
+ * kernel del precedente.
+ *
+ * Con RunConfig::completion = Callback il download viene accodato subito dopo il kernel e il
+ * task arriva al thread Consumer solo al completamento (vedi DownloadCompletion).
+ *
+ * Il programma viene compilato una sola volta per dispositivo e driver: le esecuzioni
+ * successive caricano i binari dalla cache su disco (vedi ProgramCache).
  */
 class Gpu_OpenCL_Accelerator : public IAccelerator {
  public:
-   Gpu_OpenCL_Accelerator(const std::string &kernel_path, const std::string &kernel_name);
+   Gpu_OpenCL_Accelerator(const std::string &kernel_path, const std::string &kernel_name,
+                          size_t device_index = 0,
+                          cl_device_type device_type = CL_DEVICE_TYPE_GPU,
+                          const RunConfig &config = RunConfig(),
+                          std::shared_ptr<OpenClDeviceContext> shared = nullptr);
    ~Gpu_OpenCL_Accelerator() override;
 
+   // Restituisce tutti i dispositivi del tipo richiesto, su tutte le piattaforme OpenCL.
+   static std::vector<cl_device_id> list_devices(cl_device_type device_type);
+
    // Esegue tutte le operazioni di setup una volta sola (creare contesto,
    // coda comandi, compilare kernel, inizializzare pool buffer).
    bool initialize() override;
@@ -32,16 +84,33 @@ class Gpu_OpenCL_Accelerator : public IAccelerator {
    void send_data_to_device(void *task_context) override;
    void execute_kernel(void *task_context) override;
    void get_results_from_device(void *task_context, long long &computed_ns) override;
+   void start_results_download(void *task_context, CompletionFn on_complete,
+                               void *user_data) override;
+   void finish_results_download(void *task_context) override;
 
    // Metodi per l'acquisizione e il rilascio dei buffer.
-   size_t acquire_buffer_set() override;
+   size_t acquire_buffer_set(size_t required_size_bytes) override;
    void release_buffer_set(size_t index) override;
 
+   // Nome del dispositivo e uso del pool di buffer.
+   void report_stats(ComputeResult &res) override;
+
  private:
-   cl_context context_{nullptr};     // Il contesto OpenCL
-   cl_command_queue queue_{nullptr}; // La coda di comandi OpenCL
-   cl_program program_{nullptr};     // Il programma OpenCL (kernel compilato)
-   cl_kernel kernel_{nullptr};       // Il kernel OpenCL (func da eseguire)
+   // Versioni a chunk dei tre stadi (RunConfig::chunk_size > 0).
+   void send_chunks_to_device(Task *task, BufferManager::BufferSet &buffers);
+   void execute_chunks(Task *task);
+   void get_chunk_results(Task *task, BufferManager::BufferSet &buffers);
+   cl_int enqueue_chunk_reads(Task *task, BufferManager::BufferSet &buffers);
+
+   // Crea contesto e programma del dispositivo in shared_ (primo worker che si inizializza).
+   bool create_context_and_program(cl_device_id device_id);
+
+   // Contesto e programma del dispositivo, propri o condivisi con gli altri worker.
+   std::shared_ptr<OpenClDeviceContext> shared_;
+   cl_context context_{nullptr}; // Il contesto OpenCL
+   CommandQueues queues_;        // Le code di comandi OpenCL (upload, kernel, download)
+   cl_program program_{nullptr}; // Il programma OpenCL (kernel compilato)
+   cl_kernel kernel_{nullptr};   // Il kernel OpenCL (func da eseguire)
 
    // Incapsula la logica per l'acquisizione, il rilascio e la riallocazione dei buffer di
    // memoria sul device.
@@ -49,4 +118,14 @@ class Gpu_OpenCL_Accelerator : public IAccelerator {
 
    std::string kernel_path_;
    std::string kernel_name_;
+   std::string device_name_;    // CL_DEVICE_NAME del dispositivo usato
+   size_t device_index_;        // Indice del dispositivo fra quelli trovati
+   cl_device_type device_type_; // Tipo di dispositivo cercato (GPU, CPU, ...)
+   size_t chunk_size_;          // Elementi per chunk, 0 = task intero
+   ClQueueMode queue_mode_;     // Code di comandi richieste
+   MemMode mem_mode_;           // Memoria dell'host per i trasferimenti
+   RunConfig config_;           // Opzioni di esecuzione (per il pool di buffer)
+   bool program_built_{false};    // Programma creato da questa istanza (non condiviso)
+   bool program_cached_{false};   // Programma caricato dalla cache dei binari
+   long long program_build_ns_{0}; // Tempo per ottenere il programma compilato
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../common/ComputeResult.hpp"
 #include "../../common/Task.hpp"
 
 /**
@@ -9,9 +10,17 @@
  * principali che implementano i due thread della pipeline interna:
  * - Thread Producer (stadi 1 e 2): send_data_to_device() e execute_kernel().
  * - Thread Consumer (stadio 3): get_results_from_device().
+ *
+ * Con RunConfig::completion = Callback lo stadio 3 usa invece start_results_download(),
+ * chiamata dal Producer subito dopo execute_kernel(), e finish_results_download() sul thread
+ * Consumer.
  */
 class IAccelerator {
  public:
+   // Funzione chiamata al completamento di un download asincrono, con il task e il dato
+   // passato a start_results_download().
+   using CompletionFn = void (*)(void *task_context, void *user_data);
+
    virtual ~IAccelerator() = default;
 
    // Esegue tutte le operazioni di setup una tantum.
@@ -44,15 +53,62 @@ class IAccelerator {
     */
    virtual void get_results_from_device(void *task_context, long long &computed_ns) = 0;
 
+   /**
+    * @brief Stadio 3 - Download asincrono: accoda il download dei risultati dopo il kernel
+    * senza attenderlo e chiama on_complete, anche da un thread del runtime, quando i risultati
+    * sono sull'host. Il tempo impiegato viene scritto in Task::computed_ns. Di default esegue
+    * il download bloccante e chiama subito on_complete.
+    */
+   virtual void start_results_download(void *task_context, CompletionFn on_complete,
+                                       void *user_data) {
+      auto *task = static_cast<Task *>(task_context);
+      get_results_from_device(task_context, task->computed_ns);
+      on_complete(task_context, user_data);
+   }
+
+   /**
+    * @brief Completa sul thread Consumer un download asincrono terminato (es. tempi di
+    * profiling, rilascio delle risorse del task). Di default non fa nulla.
+    */
+   virtual void finish_results_download(void *) {}
+
    /**
     * @brief Acquisisce un set di buffer libero dal pool del device.
+    * @param required_size_bytes Dimensione in byte di ogni vettore del task.
     * @return L'indice del set di buffer acquisito.
     */
-   virtual size_t acquire_buffer_set() = 0;
+   virtual size_t acquire_buffer_set(size_t required_size_bytes) = 0;
 
    /**
     * @brief Rilascia un set di buffer nel pool del device.
     * @param index L'indice del set da rilasciare.
     */
    virtual void release_buffer_set(size_t index) = 0;
+
+   /**
+    * @brief Aggiunge al risultato le statistiche proprie dell'acceleratore (es. l'uso del pool
+    * di buffer), al termine dell'esecuzione. Di default non aggiunge nulla.
+    */
+   virtual void report_stats(ComputeResult &) {}
+
+ protected:
+   /**
+    * @brief Aggiunge 'name' ai dispositivi del risultato, se non è già presente (più worker di
+    * una farm possono usare lo stesso dispositivo).
+    */
+   static void add_device_name(ComputeResult &res, const std::string &name) {
+      if (name.empty() || res.device_names.find(name) != std::string::npos)
+         return;
+      if (!res.device_names.empty())
+         res.device_names += ", ";
+      res.device_names += name;
+   }
+
+   /**
+    * @brief Aggiunge la compilazione di un programma OpenCL alle statistiche di avvio.
+    */
+   static void add_program_build(ComputeResult &res, bool from_cache, long long build_ns) {
+      res.program_build_ns += build_ns;
+      ++(from_cache ? res.programs_cached : res.programs_compiled);
+   }
 };
\ No newline at end of file
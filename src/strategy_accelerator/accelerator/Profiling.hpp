@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../../common/ComputeResult.hpp"
+#include "../../common/Task.hpp"
+
+#include <vector>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+/**
+ * @brief Profiling OpenCL dei task (RunConfig::profile), per Gpu_OpenCL_Accelerator e
+ * Fpga_Accelerator.
+ *
+ * Con le code create con CL_QUEUE_PROFILING_ENABLE ogni evento riporta gli istanti QUEUED,
+ * SUBMIT, START ed END del proprio comando. Gli eventi dei comandi di upload, kernel e
+ * download di un task vengono conservati in Task::profile_events e letti solo al termine del
+ * download, quando tutti i comandi del task sono completi: i tempi risultanti misurano il
+ * lavoro del device e non l'attesa dell'host, come invece fa il tempo misurato attorno al
+ * download.
+ */
+
+/**
+ * @brief Lista in cui conservare gli eventi di uno stadio del task, o nullptr se il profiling
+ * non è attivo (i comandi vengono allora accodati senza evento, come in origine).
+ */
+inline std::vector<cl_event> *profile_events(Task *task, DeviceTime stage, bool enabled) {
+   return enabled ? &task->profile_events[stage] : nullptr;
+}
+
+/**
+ * @brief Conserva nella lista 'profile' (se presente) un evento usato anche altrove,
+ * aggiungendo un riferimento.
+ */
+inline void keep_profile_event(std::vector<cl_event> *profile, cl_event event) {
+   if (!profile || !event)
+      return;
+   clRetainEvent(event);
+   profile->push_back(event);
+}
+
+/**
+ * @brief Legge i tempi degli eventi conservati per il task, li rilascia e scrive in
+ * task->device_ns la durata di ogni stadio (dall'inizio del primo comando alla fine
+ * dell'ultimo) e l'attesa del primo comando di ogni stadio prima dell'esecuzione.
+ */
+inline void collect_device_times(Task *task) {
+   task->device_ns.fill(0);
+
+   for (size_t stage = DEVICE_H2D; stage <= DEVICE_D2H; ++stage) {
+      auto &events = task->profile_events[stage];
+      cl_ulong first_queued = 0, first_submit = 0, first_start = 0, last_end = 0;
+      bool any = false;
+
+      for (cl_event event : events) {
+         cl_ulong queued, submit, start, end;
+         cl_int ret = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_QUEUED,
+                                              sizeof(queued), &queued, NULL);
+         ret |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_SUBMIT, sizeof(submit),
+                                        &submit, NULL);
+         ret |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start),
+                                        &start, NULL);
+         ret |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end,
+                                        NULL);
+         clReleaseEvent(event);
+         if (ret != CL_SUCCESS)
+            continue;
+
+         // Il primo comando dello stadio è quello accodato per primo.
+         if (!any || queued < first_queued) {
+            first_queued = queued;
+            first_submit = submit;
+         }
+         if (!any || start < first_start)
+            first_start = start;
+         if (end > last_end)
+            last_end = end;
+         any = true;
+      }
+      events.clear();
+
+      if (!any)
+         continue;
+      if (last_end > first_start)
+         task->device_ns[stage] = static_cast<long long>(last_end - first_start);
+      if (first_submit > first_queued)
+         task->device_ns[DEVICE_QUEUED] += static_cast<long long>(first_submit - first_queued);
+      if (first_start > first_submit)
+         task->device_ns[DEVICE_SUBMITTED] +=
+            static_cast<long long>(first_start - first_submit);
+   }
+   task->profiled = true;
+}
@@ -0,0 +1,206 @@
+#include "ProgramCache.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * Formato di un file della cache: la chiave completa (per escludere le collisioni dell'hash)
+ * e i binari del programma, ognuno preceduto dalla propria lunghezza.
+ */
+static const char CACHE_MAGIC[8] = {'T', 'E', 'S', 'I', 'K', 'C', '0', '1'};
+
+/**
+ * Helper interno per una stringa di informazioni del dispositivo o della piattaforma.
+ */
+static std::string device_string(cl_device_id device, cl_device_info param) {
+   size_t size = 0;
+   if (clGetDeviceInfo(device, param, 0, NULL, &size) != CL_SUCCESS || size == 0)
+      return "";
+   std::string value(size, '\0');
+   clGetDeviceInfo(device, param, size, &value[0], NULL);
+   value.resize(size - 1); // Senza il terminatore
+   return value;
+}
+
+static std::string platform_version(cl_device_id device) {
+   cl_platform_id platform = NULL;
+   size_t size = 0;
+   if (clGetDeviceInfo(device, CL_DEVICE_PLATFORM, sizeof(platform), &platform, NULL) !=
+          CL_SUCCESS ||
+       clGetPlatformInfo(platform, CL_PLATFORM_VERSION, 0, NULL, &size) != CL_SUCCESS ||
+       size == 0)
+      return "";
+   std::string value(size, '\0');
+   clGetPlatformInfo(platform, CL_PLATFORM_VERSION, size, &value[0], NULL);
+   value.resize(size - 1);
+   return value;
+}
+
+/**
+ * Helper interno per l'hash FNV-1a a 64 bit della chiave, usato come nome del file.
+ */
+static std::string key_hash(const std::string &key) {
+   uint64_t hash = 14695981039346656037ull;
+   for (unsigned char c : key) {
+      hash ^= c;
+      hash *= 1099511628211ull;
+   }
+   char name[17];
+   std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+   return name;
+}
+
+static void write_block(std::ofstream &out, const void *data, uint64_t size) {
+   out.write(reinterpret_cast<const char *>(&size), sizeof(size));
+   out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+}
+
+static bool read_block(std::ifstream &in, std::vector<unsigned char> &data) {
+   uint64_t size = 0;
+   if (!in.read(reinterpret_cast<char *>(&size), sizeof(size)) || size > (1ull << 31))
+      return false;
+   data.resize(size);
+   return static_cast<bool>(in.read(reinterpret_cast<char *>(data.data()), size));
+}
+
+/**
+ * Helper interno che legge i binari in cache per 'key'. false se il file manca o non
+ * corrisponde alla chiave.
+ */
+static bool load_binary(const std::string &path, const std::string &key,
+                        std::vector<unsigned char> &binary) {
+   std::ifstream in(path, std::ios::binary);
+   char magic[sizeof(CACHE_MAGIC)];
+   std::vector<unsigned char> stored_key;
+   if (!in || !in.read(magic, sizeof(magic)) ||
+       !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) || !read_block(in, stored_key))
+      return false;
+   if (std::string(stored_key.begin(), stored_key.end()) != key)
+      return false;
+   return read_block(in, binary) && !binary.empty();
+}
+
+/**
+ * Helper interno che salva i binari del programma compilato. Il file viene scritto con un nome
+ * temporaneo e poi rinominato, così più acceleratori che compilano lo stesso programma in
+ * parallelo (farm) non lasciano mai un file parziale.
+ */
+static void store_binary(cl_program program, const std::string &dir, const std::string &path,
+                         const std::string &key, const char *tag) {
+   size_t binary_size = 0;
+   if (clGetProgramInfo(program, CL_PROGRAM_BINARY_SIZES, sizeof(binary_size), &binary_size,
+                        NULL) != CL_SUCCESS ||
+       binary_size == 0)
+      return;
+   std::vector<unsigned char> binary(binary_size);
+   unsigned char *binaries[] = {binary.data()};
+   if (clGetProgramInfo(program, CL_PROGRAM_BINARIES, sizeof(binaries), binaries, NULL) !=
+       CL_SUCCESS)
+      return;
+
+   std::error_code error;
+   std::filesystem::create_directories(dir, error);
+   std::string tmp_path =
+      path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+   {
+      std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+      out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+      write_block(out, key.data(), key.size());
+      write_block(out, binary.data(), binary.size());
+      if (!out) {
+         std::cerr << "[WARNING] " << tag << ": Could not write kernel cache in '" << dir
+                   << "'.\n";
+         std::filesystem::remove(tmp_path, error);
+         return;
+      }
+   }
+   std::filesystem::rename(tmp_path, path, error);
+   if (error)
+      std::filesystem::remove(tmp_path, error);
+}
+
+/**
+ * Helper interno per la compilazione del programma, con la stampa del log in caso di errore.
+ */
+static bool build(cl_program program, cl_device_id device, const std::string &options,
+                  const char *tag, bool report_errors) {
+   cl_int ret = clBuildProgram(program, 1, &device, options.c_str(), NULL, NULL);
+   if (ret == CL_SUCCESS)
+      return true;
+   if (report_errors) {
+      std::cerr << "[ERROR] " << tag << ": Kernel compilation failed.\n";
+      size_t log_size = 0;
+      clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size);
+      std::vector<char> log(log_size + 1, '\0');
+      clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, log_size, log.data(), NULL);
+      std::cerr << log.data() << "\n";
+   }
+   return false;
+}
+
+ProgramBuild build_program(cl_context context, cl_device_id device, const std::string &source,
+                           const std::string &options, const std::string &cache_dir,
+                           const char *tag) {
+   auto t0 = std::chrono::steady_clock::now();
+   ProgramBuild result;
+   cl_int ret;
+
+   // Chiave: tutto ciò che può cambiare il binario prodotto dal compilatore.
+   std::string key = source + '\0' + options + '\0' + device_string(device, CL_DEVICE_NAME) +
+                     '\0' + device_string(device, CL_DRIVER_VERSION) + '\0' +
+                     device_string(device, CL_DEVICE_VERSION) + '\0' +
+                     platform_version(device);
+   std::string path = cache_dir.empty() ? "" : cache_dir + "/" + key_hash(key) + ".bin";
+
+   // Prova con i binari in cache. Un binario rifiutato dal runtime viene ricompilato.
+   std::vector<unsigned char> binary;
+   if (!path.empty() && load_binary(path, key, binary)) {
+      const unsigned char *binaries[] = {binary.data()};
+      const size_t sizes[] = {binary.size()};
+      cl_int status = CL_SUCCESS;
+      cl_program program =
+         clCreateProgramWithBinary(context, 1, &device, sizes, binaries, &status, &ret);
+      if (program && ret == CL_SUCCESS && status == CL_SUCCESS &&
+          build(program, device, options, tag, false)) {
+         result.program = program;
+         result.from_cache = true;
+      } else {
+         std::cerr << "[WARNING] " << tag << ": Cached kernel binary rejected, rebuilding.\n";
+         if (program)
+            clReleaseProgram(program);
+      }
+   }
+
+   if (!result.program) {
+      const char *source_str = source.c_str();
+      size_t source_size = source.length();
+      cl_program program =
+         clCreateProgramWithSource(context, 1, &source_str, &source_size, &ret);
+      if (!program || ret != CL_SUCCESS) {
+         std::cerr << "[ERROR] " << tag << ": Failed to create program.\n";
+         return result;
+      }
+      if (!build(program, device, options, tag, true)) {
+         clReleaseProgram(program);
+         return result;
+      }
+      result.program = program;
+      if (!path.empty())
+         store_binary(program, cache_dir, path, key, tag);
+   }
+
+   result.build_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count();
+   std::cerr << "[" << tag << "] Kernel "
+             << (result.from_cache ? "loaded from cache" : "compiled") << " in "
+             << result.build_ns / 1.0e6 << " ms.\n";
+   return result;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+/**
+ * @brief Cache su disco dei programmi OpenCL compilati (RunConfig::kernel_cache_dir), usata da
+ * Gpu_OpenCL_Accelerator.
+ *
+ * clBuildProgram da sorgente può richiedere centinaia di ms per i kernel più pesanti, più di
+ * un'esecuzione breve. Dopo la prima compilazione i binari del programma
+ * (CL_PROGRAM_BINARIES) vengono salvati in un file il cui nome è l'hash della chiave:
+ * sorgente, opzioni di compilazione, nome del dispositivo, versione del driver e della
+ * piattaforma.
+ * Le esecuzioni successive con la stessa chiave creano il programma con
+ * clCreateProgramWithBinary. Un aggiornamento del driver cambia la chiave, quindi un binario
+ * non più valido non viene mai caricato; se il caricamento fallisce comunque, il programma
+ * viene ricompilato da sorgente e il file sovrascritto.
+ */
+struct ProgramBuild {
+   cl_program program{nullptr}; // nullptr se la compilazione è fallita
+   bool from_cache{false};      // Programma creato dai binari in cache
+   long long build_ns{0};       // Tempo per ottenere il programma compilato
+};
+
+/**
+ * @brief Crea e compila il programma di 'source' per 'device', passando dalla cache in
+ * 'cache_dir' (vuota = nessuna cache). In caso di errore stampa il log di compilazione.
+ * @param tag Nome dell'acceleratore, per i messaggi di log.
+ */
+ProgramBuild build_program(cl_context context, cl_device_id device, const std::string &source,
+                           const std::string &options, const std::string &cache_dir,
+                           const char *tag);
@@ -2,9 +2,10 @@
 
 #include "../common/ComputeResult.hpp"
 #include "../common/IDeviceRunner.hpp"
+#include "../common/Tracer.hpp"
+#include "SimdKernels.hpp"
 
 #include <chrono>
-#include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -23,9 +24,14 @@ class AbstractCpuRunner : public IDeviceRunner {
    /**
     * @param kernel_name Nome del kernel da eseguire.
     * @param runner_tag Stringa per i log (es. "CPU OpenMP").
+    * @param simd Set di istruzioni vettoriali dei kernel (vedi SimdKernels).
     */
-   AbstractCpuRunner(const std::string &kernel_name, const std::string &runner_tag)
-       : kernel_name_(kernel_name), runner_tag_(runner_tag) {}
+   AbstractCpuRunner(const std::string &kernel_name, const std::string &runner_tag,
+                     SimdMode simd = SimdMode::Auto)
+       : kernel_name_(kernel_name), runner_tag_(runner_tag) {
+      // Nel corpo: select_cpu_kernel scrive simd_, che deve essere già inizializzato.
+      kernel_fn_ = select_cpu_kernel(kernel_name, simd, &simd_);
+   }
 
    virtual ~AbstractCpuRunner() = default;
 
@@ -35,8 +41,7 @@ class AbstractCpuRunner : public IDeviceRunner {
     */
    ComputeResult execute(size_t N, size_t NUM_TASKS) override {
       // Validazione del kernel.
-      if (kernel_name_ != "vecAdd" && kernel_name_ != "polynomial_op" &&
-          kernel_name_ != "heavy_compute_kernel") {
+      if (!kernel_fn_) {
 
          std::cerr << "[ERROR] " << runner_tag_ << ": Unknown kernel name '" << kernel_name_
                    << "'.\n"
@@ -45,7 +50,8 @@ class AbstractCpuRunner : public IDeviceRunner {
          exit(EXIT_FAILURE);
       }
 
-      std::cout << "[" << runner_tag_ << "] Running tasks in PARALLEL on all CPU cores.\n\n";
+      std::cout << "[" << runner_tag_ << "] Running tasks in PARALLEL on all CPU cores (SIMD: "
+                << simd_name(simd_) << ").\n\n";
 
       // Inizializzazione dei dati.
       a_.resize(N);
@@ -57,6 +63,7 @@ class AbstractCpuRunner : public IDeviceRunner {
       }
 
       size_t tasks_completed = 0;
+      Tracer::set_thread_name(runner_tag_.c_str());
       auto t0 = std::chrono::steady_clock::now();
 
       // Esegue NUM_TASKS volte il calcolo parallelo in modo sequenziale.
@@ -65,7 +72,9 @@ class AbstractCpuRunner : public IDeviceRunner {
                    << " with N=" << N << "...\n";
 
          // Chiamata al metodo che esegue il calcolo parallelo (definito nelle sottoclassi).
+         auto task_start = std::chrono::steady_clock::now();
          execute_parallel_loop(0, N);
+         Tracer::complete("Task", task_num, task_start, std::chrono::steady_clock::now());
 
          std::cerr << "[" << runner_tag_ << " - END] Task " << task_num + 1 << " finished.\n";
          tasks_completed++;
@@ -76,6 +85,7 @@ class AbstractCpuRunner : public IDeviceRunner {
       auto t1 = std::chrono::steady_clock::now();
       res.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
       res.tasks_completed = tasks_completed;
+      Tracer::dump();
       return res;
    }
 
@@ -86,41 +96,17 @@ class AbstractCpuRunner : public IDeviceRunner {
    virtual void execute_parallel_loop(long start, long end) = 0;
 
    /**
-    * @brief Logica di calcolo del kernel. Viene chiamato N volte nel loop parallelo dalle
-    * sottoclassi.
+    * @brief Logica di calcolo del kernel sugli elementi [start, end). Viene chiamato dal loop
+    * parallelo delle sottoclassi una volta per ogni intervallo contiguo assegnato a un thread.
     */
-   void execute_kernel_work(long i) {
-      if (kernel_name_ == "vecAdd") {
-         // --------------------------------------------------------------
-         // SOMMA VETTORIALE
-         // --------------------------------------------------------------
-         c_[i] = a_[i] + b_[i];
-
-      } else if (kernel_name_ == "polynomial_op") {
-         // --------------------------------------------------------------
-         // OPERAZIONE POLINOMIALE (Calcolo 2a² + 3a³ - 4b² + 5b⁵)
-         // --------------------------------------------------------------
-         long long val_a = a_[i], val_b = b_[i];
-         long long a2 = val_a * val_a, a3 = a2 * val_a;
-         long long b2 = val_b * val_b, b4 = b2 * b2, b5 = b4 * val_b;
-
-         c_[i] = (int)((2 * a2) + (3 * a3) - (4 * b2) + (5 * b5));
-
-      } else if (kernel_name_ == "heavy_compute_kernel") {
-         // --------------------------------------------------------------
-         // COMPUTAZIONE MOLTO PESANTE (for interno e fz. trigonometriche)
-         // --------------------------------------------------------------
-         double val_a = (double)a_[i], val_b = (double)b_[i], result = 0.0;
-
-         for (int j = 0; j < 5; ++j)
-            result += std::sin(val_a + j) * std::cos(val_b - j);
-
-         c_[i] = (int)result;
-      }
+   void execute_kernel_range(long start, long end) {
+      kernel_fn_(a_.data(), b_.data(), c_.data(), start, end);
    }
 
  protected:
    std::vector<int> a_, b_, c_; // Vettori di dati input/output
    std::string kernel_name_;
    std::string runner_tag_; // Device name per i log
+   KernelRangeFn kernel_fn_{nullptr}; // Kernel scelto per nome (nullptr se ignoto)
+   SimdMode simd_{SimdMode::Off};     // Set di istruzioni del kernel scelto
 };
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+/**
+ * @brief Logica di calcolo dei kernel su CPU, condivisa dai runner CPU (AbstractCpuRunner) e
+ * dai worker CPU della farm ibrida (ff_node_cpu_t).
+ *
+ * Ogni kernel è un tipo con la funzione statica apply(a, b) per un elemento. Il kernel viene
+ * scelto per nome una sola volta (cpu_kernel_range) e i loop paralleli chiamano la funzione
+ * ottenuta su intervalli contigui di elementi: il corpo di ogni intervallo è un loop senza
+ * salti né chiamate, che il compilatore può vettorizzare.
+ */
+
+// --------------------------------------------------------------
+// SOMMA VETTORIALE
+// --------------------------------------------------------------
+struct VecAddKernel {
+   static int apply(int a, int b) { return a + b; }
+};
+
+// --------------------------------------------------------------
+// OPERAZIONE POLINOMIALE (Calcolo 2a² + 3a³ - 4b² + 5b⁵)
+// --------------------------------------------------------------
+struct PolynomialKernel {
+   static int apply(int a, int b) {
+      long long val_a = a, val_b = b;
+      long long a2 = val_a * val_a, a3 = a2 * val_a;
+      long long b2 = val_b * val_b, b4 = b2 * b2, b5 = b4 * val_b;
+
+      return (int)((2 * a2) + (3 * a3) - (4 * b2) + (5 * b5));
+   }
+};
+
+// --------------------------------------------------------------
+// COMPUTAZIONE MOLTO PESANTE (for interno e fz. trigonometriche)
+// --------------------------------------------------------------
+struct HeavyComputeKernel {
+   static int apply(int a, int b) {
+      double val_a = (double)a, val_b = (double)b, result = 0.0;
+
+      for (int j = 0; j < 5; ++j)
+         result += std::sin(val_a + j) * std::cos(val_b - j);
+
+      return (int)result;
+   }
+};
+
+/**
+ * @brief Calcola c[i] = Kernel::apply(a[i], b[i]) per i in [start, end).
+ */
+template <typename Kernel>
+void compute_kernel_range(const int *__restrict a, const int *__restrict b, int *__restrict c,
+                          long start, long end) {
+   for (long i = start; i < end; ++i)
+      c[i] = Kernel::apply(a[i], b[i]);
+}
+
+// Funzione che calcola un intervallo di elementi con un kernel già scelto.
+using KernelRangeFn = void (*)(const int *, const int *, int *, long, long);
+
+/**
+ * @brief Ritorna la funzione che calcola gli intervalli del kernel scelto, o nullptr se il
+ * kernel non ha un'implementazione su CPU.
+ */
+inline KernelRangeFn cpu_kernel_range(const std::string &kernel_name) {
+   if (kernel_name == "vecAdd")
+      return compute_kernel_range<VecAddKernel>;
+   if (kernel_name == "polynomial_op")
+      return compute_kernel_range<PolynomialKernel>;
+   if (kernel_name == "heavy_compute_kernel")
+      return compute_kernel_range<HeavyComputeKernel>;
+   return nullptr;
+}
+
+/**
+ * @brief Ritorna true se il kernel ha un'implementazione su CPU.
+ */
+inline bool is_cpu_kernel(const std::string &kernel_name) {
+   return cpu_kernel_range(kernel_name) != nullptr;
+}
@@ -1,17 +1,18 @@
 #include "Cpu_FF_Runner.hpp"
 
-Cpu_FF_Runner::Cpu_FF_Runner(const std::string &kernel_name)
-    : AbstractCpuRunner(kernel_name, "CPU Parallel FF") {}
+Cpu_FF_Runner::Cpu_FF_Runner(const std::string &kernel_name, SimdMode simd)
+    : AbstractCpuRunner(kernel_name, "CPU Parallel FF", simd) {}
 
 /**
  * @brief Implementazione del loop parallelo con FastFlow. Questa funzione viene chiamata dal
  * metodo execute() della classe base AbstractCpuRunner.
  */
 void Cpu_FF_Runner::execute_parallel_loop(long start, long end) {
-   // Parallelizza il calcolo usando parallel_for di FastFlow che gestisce il parallelismo a
-   // dati su CPU distribuendo le iterazioni del loop sui core disponibili.
-   pf_.parallel_for(start, end, 1, 0, [&](const long i) {
+   // Parallelizza il calcolo usando parallel_for_idx di FastFlow che gestisce il parallelismo
+   // a dati su CPU distribuendo le iterazioni del loop sui core disponibili, un intervallo
+   // contiguo per ogni worker.
+   pf_.parallel_for_idx(start, end, 1, 0, [&](const long first, const long last, const int) {
       // Chiama l'helper della classe base che contiene la logica di calcolo del kernel.
-      this->execute_kernel_work(i);
+      this->execute_kernel_range(first, last);
    });
 }
\ No newline at end of file
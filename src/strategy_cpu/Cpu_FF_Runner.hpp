@@ -10,7 +10,7 @@
  */
 class Cpu_FF_Runner : public AbstractCpuRunner {
  public:
-   explicit Cpu_FF_Runner(const std::string &kernel_name);
+   explicit Cpu_FF_Runner(const std::string &kernel_name, SimdMode simd = SimdMode::Auto);
    virtual ~Cpu_FF_Runner() = default;
 
  protected:
@@ -0,0 +1,105 @@
+#include "Cpu_FF_Stream_Runner.hpp"
+
+#include "../../include/ff_includes.hpp"
+#include "../common/StatsCollector.hpp"
+#include "../common/Tracer.hpp"
+#include "../ff_Pipe_nodes/FileSink.hpp"
+#include "../ff_Pipe_nodes/FileSource.hpp"
+#include "../ff_Pipe_nodes/ff_node_cpu_t.hpp"
+#include "CpuKernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// Task in coda per ogni worker (scheduling on-demand): uno in attesa mentre il worker calcola
+// il precedente, così i worker più veloci ricevono più task.
+static constexpr int WORKER_QUEUE_SLOTS = 2;
+
+Cpu_FF_Stream_Runner::Cpu_FF_Stream_Runner(const std::string &kernel_name,
+                                           const RunConfig &config)
+    : kernel_name_(kernel_name), config_(config) {}
+
+/**
+ * @brief Crea la farm di cpu_workers nodi ff_node_cpu_t, la esegue e raccoglie le statistiche
+ * di tutti i worker.
+ */
+ComputeResult Cpu_FF_Stream_Runner::execute(size_t N, size_t NUM_TASKS) {
+   if (!is_cpu_kernel(kernel_name_))
+      throw std::invalid_argument("Unknown kernel name '" + kernel_name_ +
+                                  "' for cpu_ff_stream. Supported kernels are: 'vecAdd', "
+                                  "'polynomial_op', 'heavy_compute_kernel'.");
+
+   const size_t num_workers = config_.cpu_workers;
+   if (num_workers == 0)
+      throw std::invalid_argument("cpu_ff_stream needs at least one CPU worker.");
+
+   // Thread per worker: di default i core divisi fra i worker, così task in parallelo per
+   // thread per task coprono la CPU senza sovrapporsi.
+   size_t cpu_threads = config_.cpu_threads;
+   if (cpu_threads == 0) {
+      size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+      cpu_threads = std::max<size_t>(cores / num_workers, 1);
+   }
+
+   StatsCollector stats;
+   stats.active_consumers = num_workers;
+   std::future<size_t> count_future = stats.count_promise.get_future();
+
+   // Con --sink i worker inviano i task calcolati al collector della farm, seguito dal
+   // FileSink.
+   const bool sink = !config_.sink_path.empty();
+   std::unique_ptr<ff_node> source = make_source_node(config_, N, NUM_TASKS);
+   std::unique_ptr<FileSink> file_sink;
+   if (sink)
+      file_sink = std::make_unique<FileSink>(config_.sink_path, N);
+
+   std::vector<std::unique_ptr<ff_node_cpu_t>> nodes;
+   std::vector<ff_node *> workers;
+   for (size_t w = 0; w < num_workers; ++w) {
+      // Nessun WorkerLoad: i task vengono distribuiti on-demand dalla farm.
+      nodes.push_back(std::make_unique<ff_node_cpu_t>(kernel_name_, cpu_threads, &stats,
+                                                      nullptr, config_.simd));
+      nodes.back()->set_forward_output(sink);
+      workers.push_back(nodes.back().get());
+   }
+
+   ff_farm farm;
+   farm.add_workers(workers);
+   farm.set_scheduling_ondemand(WORKER_QUEUE_SLOTS);
+   if (!sink)
+      farm.remove_collector(); // I worker sono nodi terminali
+   ff_Pipe<> pipe(source.get(), &farm);
+   if (sink)
+      pipe.add_stage(file_sink.get());
+
+   SimdMode simd_used = SimdMode::Off;
+   select_cpu_kernel(kernel_name_, config_.simd, &simd_used);
+   std::cout << "[CPU Stream FF] Farm with " << num_workers << " CPU workers ("
+             << cpu_threads << " threads each, SIMD: " << simd_name(simd_used) << ").\n";
+
+   std::cout << "[Main] Starting FF pipeline execution...\n";
+   auto t0 = std::chrono::steady_clock::now();
+
+   if (pipe.run_and_wait_end() < 0) {
+      std::cerr << "[ERROR] Main: Pipeline execution failed.\n";
+      exit(EXIT_FAILURE);
+   }
+
+   auto t1 = std::chrono::steady_clock::now();
+   std::cout << "[Main] FF Pipeline execution finished.\n";
+
+   // Raccolta dei risultati.
+   ComputeResult res;
+   res.tasks_completed = count_future.get();
+   res.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+   stats.fill_result(res);
+   res.first_task_ns = stats.first_task_ns(t0);
+
+   // I thread della pipeline sono terminati: i buffer della traccia possono essere letti.
+   Tracer::dump();
+   return res;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../common/IDeviceRunner.hpp"
+#include "../common/RunConfig.hpp"
+#include <string>
+
+/**
+ * @brief Strategia concreta che esegue i task su CPU come uno stream, con due livelli di
+ * parallelismo.
+ *
+ * A differenza di Cpu_FF_Runner, che calcola un task alla volta con un ParallelFor su tutti i
+ * core, la pipeline FF è Emitter -> farm di RunConfig::cpu_workers nodi ff_node_cpu_t: più
+ * task sono in calcolo contemporaneamente (parallelismo fra task), ognuno con un ParallelFor
+ * su RunConfig::cpu_threads core (parallelismo a dati). I nodi aggiornano le stesse
+ * statistiche dei nodi acceleratore, quindi il risultato contiene anche tempo di servizio e
+ * latenze nel nodo, confrontabili con quelli di gpu_opencl e hybrid.
+ */
+class Cpu_FF_Stream_Runner : public IDeviceRunner {
+ public:
+   /**
+    * @param kernel_name Nome del kernel da eseguire.
+    * @param config Opzioni di esecuzione (worker e thread CPU, set di istruzioni).
+    */
+   Cpu_FF_Stream_Runner(const std::string &kernel_name, const RunConfig &config = RunConfig());
+
+   virtual ~Cpu_FF_Stream_Runner() = default;
+
+   ComputeResult execute(size_t N, size_t NUM_TASKS) override;
+
+ private:
+   std::string kernel_name_;
+   RunConfig config_;
+};
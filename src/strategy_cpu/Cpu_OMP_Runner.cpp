@@ -2,18 +2,23 @@
 
 #include <omp.h>
 
-Cpu_OMP_Runner::Cpu_OMP_Runner(const std::string &kernel_name)
-    : AbstractCpuRunner(kernel_name, "CPU OpenMP") {}
+Cpu_OMP_Runner::Cpu_OMP_Runner(const std::string &kernel_name, SimdMode simd)
+    : AbstractCpuRunner(kernel_name, "CPU OpenMP", simd) {}
 
 /**
  * @brief Implementazione del loop parallelo con OpenMP. Questa funzione viene chiamata dal
  * metodo execute() della classe base AbstractCpuRunner.
  */
 void Cpu_OMP_Runner::execute_parallel_loop(long start, long end) {
-// Dice al compilatore di parallelizzare il ciclo for distribuendolo tra i thread disponibili.
-#pragma omp parallel for
-   for (long i = start; i < end; ++i) {
+// Avvia un gruppo di thread, ognuno dei quali calcola un intervallo contiguo degli elementi
+// (come lo schedule static di 'omp parallel for').
+#pragma omp parallel
+   {
+      long num_threads = omp_get_num_threads(), thread = omp_get_thread_num();
+      long first = start + (end - start) * thread / num_threads;
+      long last = start + (end - start) * (thread + 1) / num_threads;
+
       // Chiama l'helper della classe base che contiene la logica di calcolo del kernel.
-      this->execute_kernel_work(i);
+      this->execute_kernel_range(first, last);
    }
 }
\ No newline at end of file
@@ -9,7 +9,7 @@
  */
 class Cpu_OMP_Runner : public AbstractCpuRunner {
  public:
-   explicit Cpu_OMP_Runner(const std::string &kernel_name);
+   explicit Cpu_OMP_Runner(const std::string &kernel_name, SimdMode simd = SimdMode::Auto);
    virtual ~Cpu_OMP_Runner() = default;
 
  protected:
@@ -0,0 +1,73 @@
+#include "SimdKernels.hpp"
+#include "SimdKernelsImpl.hpp"
+
+/**
+ * @brief Rilevamento del set di istruzioni e scelta dei kernel CPU vettoriali. I file dei
+ * singoli set di istruzioni vengono compilati solo su x86 (TESI_SIMD_X86, vedi CMakeLists).
+ */
+
+SimdMode detect_simd() {
+#if defined(TESI_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx512f"))
+      return SimdMode::Avx512;
+   if (__builtin_cpu_supports("avx2"))
+      return SimdMode::Avx2;
+   if (__builtin_cpu_supports("sse4.2"))
+      return SimdMode::Sse42;
+#endif
+   return SimdMode::Off;
+}
+
+const char *simd_name(SimdMode mode) {
+   switch (mode) {
+   case SimdMode::Sse42:
+      return "sse4.2";
+   case SimdMode::Avx2:
+      return "avx2";
+   case SimdMode::Avx512:
+      return "avx512";
+   case SimdMode::Auto:
+      return "auto";
+   default:
+      return "off";
+   }
+}
+
+/**
+ * Helper interno che sceglie il kernel nella tabella del set di istruzioni.
+ */
+static KernelRangeFn from_table(const SimdKernelTable &table, const std::string &kernel_name) {
+   if (kernel_name == "vecAdd")
+      return table.vec_add;
+   if (kernel_name == "polynomial_op")
+      return table.polynomial;
+   if (kernel_name == "heavy_compute_kernel")
+      return table.heavy_compute;
+   return nullptr;
+}
+
+KernelRangeFn select_cpu_kernel(const std::string &kernel_name, SimdMode mode,
+                                SimdMode *used) {
+   KernelRangeFn scalar = cpu_kernel_range(kernel_name);
+   SimdMode available = detect_simd();
+   SimdMode level = (mode == SimdMode::Auto || mode > available) ? available : mode;
+   if (used)
+      *used = scalar ? level : SimdMode::Off;
+   if (!scalar)
+      return nullptr;
+
+#ifdef TESI_SIMD_X86
+   switch (level) {
+   case SimdMode::Avx512:
+      return from_table(simd_kernels_avx512(), kernel_name);
+   case SimdMode::Avx2:
+      return from_table(simd_kernels_avx2(), kernel_name);
+   case SimdMode::Sse42:
+      return from_table(simd_kernels_sse42(), kernel_name);
+   default:
+      break;
+   }
+#endif
+   return scalar;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../common/RunConfig.hpp"
+#include "CpuKernels.hpp"
+
+#include <string>
+
+/**
+ * @brief Versioni vettoriali esplicite dei kernel CPU (SSE4.2, AVX2, AVX-512), scelte a
+ * runtime in base alla CPU che esegue il programma.
+ *
+ * polynomial_op usa moltiplicazioni intere su tutte le corsie, heavy_compute_kernel un sin/cos
+ * vettoriale (algoritmo di Cephes) al posto di std::sin/std::cos. I risultati sono uguali bit
+ * a bit a quelli dei kernel scalari: tesi-bench --suite=kernel li confronta su ogni set di
+ * istruzioni disponibile. Su CPU non x86 restano solo i kernel scalari.
+ */
+
+// Set di istruzioni più ampio supportato dalla CPU (SimdMode::Off se nessuno).
+SimdMode detect_simd();
+
+// Nome del set di istruzioni, per i log e i risultati.
+const char *simd_name(SimdMode mode);
+
+/**
+ * @brief Ritorna la funzione che calcola gli intervalli del kernel con il set di istruzioni
+ * richiesto (Auto = il più ampio disponibile), limitato a quelli supportati dalla CPU, o
+ * nullptr se il kernel non ha un'implementazione su CPU.
+ * @param used Se non nullo, riceve il set di istruzioni effettivamente usato.
+ */
+KernelRangeFn select_cpu_kernel(const std::string &kernel_name, SimdMode mode,
+                                SimdMode *used = nullptr);
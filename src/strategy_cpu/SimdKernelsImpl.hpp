@@ -0,0 +1,168 @@
+#pragma once
+
+#include "CpuKernels.hpp"
+
+/**
+ * @brief Implementazione generica dei kernel CPU vettoriali, inclusa dai file di ogni set di
+ * istruzioni (SimdKernels_sse42.cpp, SimdKernels_avx2.cpp, SimdKernels_avx512.cpp).
+ *
+ * Ogni file definisce, in un namespace anonimo, il tipo V con le operazioni sui registri del
+ * proprio set di istruzioni e istanzia i template con quel tipo: i template vengono così
+ * compilati solo con le opzioni del file (es. -mavx2) e non finiscono mai nel codice eseguito
+ * su una CPU che non le supporta. Per lo stesso motivo qui non vengono usate funzioni inline
+ * della libreria standard.
+ *
+ * I file vengono compilati con -ffp-contract=off: senza FMA le operazioni in virgola mobile
+ * sono le stesse su tutti i set di istruzioni.
+ */
+
+// Kernel vettoriali di un set di istruzioni.
+struct SimdKernelTable {
+   KernelRangeFn vec_add;
+   KernelRangeFn polynomial;
+   KernelRangeFn heavy_compute;
+};
+
+SimdKernelTable simd_kernels_sse42();
+SimdKernelTable simd_kernels_avx2();
+SimdKernelTable simd_kernels_avx512();
+
+/**
+ * @brief Chiama body(a, b, c) su blocchi consecutivi di LANES elementi di [start, end). Gli
+ * ultimi elementi passano da array locali completati con zeri, così anche la coda usa il
+ * codice vettoriale e dà gli stessi risultati.
+ */
+template <int LANES, typename Body>
+void for_each_block(const int *a, const int *b, int *c, long start, long end, Body body) {
+   long i = start;
+   for (; i + LANES <= end; i += LANES)
+      body(a + i, b + i, c + i);
+
+   if (i < end) {
+      int tail_a[LANES] = {}, tail_b[LANES] = {}, tail_c[LANES];
+      for (long k = 0; k < end - i; ++k) {
+         tail_a[k] = a[i + k];
+         tail_b[k] = b[i + k];
+      }
+      body(tail_a, tail_b, tail_c);
+      for (long k = 0; k < end - i; ++k)
+         c[i + k] = tail_c[k];
+   }
+}
+
+template <typename V>
+void simd_vec_add(const int *a, const int *b, int *c, long start, long end) {
+   auto block = [](const int *pa, const int *pb, int *pc) {
+      V::store_int(pc, V::add_int(V::load_int(pa), V::load_int(pb)));
+   };
+   for_each_block<V::INT_LANES>(a, b, c, start, end, block);
+}
+
+/**
+ * @brief 2a² + 3a³ - 4b² + 5b⁵ su corsie a 32 bit. Il kernel scalare calcola in 64 bit (con
+ * overflow) e tronca a 32: somme e prodotti modulo 2^64 hanno gli stessi 32 bit bassi degli
+ * stessi calcoli modulo 2^32, quindi bastano le moltiplicazioni a 32 bit, con il doppio delle
+ * corsie rispetto a quelle a 64 bit.
+ */
+template <typename V>
+void simd_polynomial(const int *a, const int *b, int *c, long start, long end) {
+   auto block = [](const int *pa, const int *pb, int *pc) {
+      auto va = V::load_int(pa), vb = V::load_int(pb);
+      auto a2 = V::mul_int(va, va), a3 = V::mul_int(a2, va);
+      auto b2 = V::mul_int(vb, vb), b4 = V::mul_int(b2, b2), b5 = V::mul_int(b4, vb);
+
+      auto result = V::add_int(V::mul_int(V::set1_int(2), a2), V::mul_int(V::set1_int(3), a3));
+      result = V::sub_int(result, V::mul_int(V::set1_int(4), b2));
+      result = V::add_int(result, V::mul_int(V::set1_int(5), b5));
+      V::store_int(pc, result);
+   };
+   for_each_block<V::INT_LANES>(a, b, c, start, end, block);
+}
+
+// Coefficienti e costanti di sin/cos della libreria Cephes (sin.c), con errore di circa 1 ulp
+// per argomenti fino a 2^30.
+constexpr double SIN_COEFFS[6] = {1.58962301576546568060E-10, -2.50507477628578072866E-8,
+                                  2.75573136213857245213E-6,  -1.98412698295895385996E-4,
+                                  8.33333333332211858878E-3,  -1.66666666666666307295E-1};
+constexpr double COS_COEFFS[6] = {-1.13585365213876817300E-11, 2.08757008419747316778E-9,
+                                  -2.75573141792967388112E-7,  2.48015872888517045348E-5,
+                                  -1.38888888888730564116E-3,  4.16666666666665929218E-2};
+constexpr double PI_OVER_4 = 7.85398163397448309616E-1;
+constexpr double DP1 = 7.85398125648498535156E-1; // pi/4 = DP1 + DP2 + DP3
+constexpr double DP2 = 3.77489470793079817668E-8;
+constexpr double DP3 = 2.69515142907905952645E-15;
+
+template <typename V> typename V::Dbl polevl(typename V::Dbl x, const double (&coeffs)[6]) {
+   typename V::Dbl result = V::set1(coeffs[0]);
+   for (int k = 1; k < 6; ++k)
+      result = V::add(V::mul(result, x), V::set1(coeffs[k]));
+   return result;
+}
+
+/**
+ * @brief Riduzione di |x| a [-pi/4, pi/4]: 'octant' è l'ottante (pari) usato, modulo 8
+ * (0, 2, 4 o 6), e 'z' il resto, calcolato in precisione estesa con DP1 + DP2 + DP3.
+ */
+template <typename V>
+void reduce_argument(typename V::Dbl abs_x, typename V::Dbl &z, typename V::Dbl &octant) {
+   auto y = V::floor(V::div(abs_x, V::set1(PI_OVER_4)));
+   // Un ottante dispari passa al successivo.
+   y = V::add(y, V::sub(y, V::mul(V::set1(2.0), V::floor(V::mul(y, V::set1(0.5))))));
+   octant = V::sub(y, V::mul(V::set1(8.0), V::floor(V::mul(y, V::set1(0.125)))));
+   z = V::sub(V::sub(V::sub(abs_x, V::mul(y, V::set1(DP1))), V::mul(y, V::set1(DP2))),
+              V::mul(y, V::set1(DP3)));
+}
+
+// Polinomi di sin e cos sull'intervallo ridotto.
+template <typename V> typename V::Dbl sin_poly(typename V::Dbl z, typename V::Dbl zz) {
+   return V::add(z, V::mul(z, V::mul(zz, polevl<V>(zz, SIN_COEFFS))));
+}
+template <typename V> typename V::Dbl cos_poly(typename V::Dbl zz) {
+   return V::add(V::sub(V::set1(1.0), V::mul(zz, V::set1(0.5))),
+                 V::mul(V::mul(zz, zz), polevl<V>(zz, COS_COEFFS)));
+}
+
+template <typename V> typename V::Dbl simd_sin(typename V::Dbl x) {
+   typename V::Dbl z, octant;
+   reduce_argument<V>(V::abs(x), z, octant);
+   auto zz = V::mul(z, z);
+
+   // Negativo per x < 0 e negli ottanti 4 e 6, polinomio del coseno negli ottanti 2 e 6.
+   auto upper = V::ge(octant, V::set1(4.0));
+   octant = V::blend(upper, V::sub(octant, V::set1(4.0)), octant);
+   auto negative = V::mask_xor(V::lt(x, V::set1(0.0)), upper);
+   auto y = V::blend(V::eq(octant, V::set1(2.0)), cos_poly<V>(zz), sin_poly<V>(z, zz));
+   return V::blend(negative, V::sub(V::set1(0.0), y), y);
+}
+
+template <typename V> typename V::Dbl simd_cos(typename V::Dbl x) {
+   typename V::Dbl z, octant;
+   reduce_argument<V>(V::abs(x), z, octant);
+   auto zz = V::mul(z, z);
+
+   // Negativo negli ottanti 2 e 4, polinomio del seno negli ottanti 2 e 6.
+   auto upper = V::ge(octant, V::set1(4.0));
+   octant = V::blend(upper, V::sub(octant, V::set1(4.0)), octant);
+   auto sine = V::eq(octant, V::set1(2.0));
+   auto y = V::blend(sine, sin_poly<V>(z, zz), cos_poly<V>(zz));
+   return V::blend(V::mask_xor(upper, sine), V::sub(V::set1(0.0), y), y);
+}
+
+template <typename V>
+void simd_heavy_compute(const int *a, const int *b, int *c, long start, long end) {
+   auto block = [](const int *pa, const int *pb, int *pc) {
+      auto val_a = V::load_double(pa), val_b = V::load_double(pb);
+      auto result = V::set1(0.0);
+
+      for (int j = 0; j < 5; ++j)
+         result = V::add(result, V::mul(simd_sin<V>(V::add(val_a, V::set1(j))),
+                                        simd_cos<V>(V::sub(val_b, V::set1(j)))));
+
+      V::store_truncated(pc, result);
+   };
+   for_each_block<V::DBL_LANES>(a, b, c, start, end, block);
+}
+
+template <typename V> SimdKernelTable make_simd_kernel_table() {
+   return {simd_vec_add<V>, simd_polynomial<V>, simd_heavy_compute<V>};
+}
@@ -0,0 +1,47 @@
+// Kernel CPU vettoriali AVX2 (registri a 256 bit), compilati con -mavx2.
+#include "SimdKernelsImpl.hpp"
+
+#include <immintrin.h>
+
+namespace {
+
+struct V {
+   using Int = __m256i;
+   using Dbl = __m256d;
+   using Mask = __m256d;
+   static constexpr int INT_LANES = 8;
+   static constexpr int DBL_LANES = 4;
+
+   static Int load_int(const int *p) { return _mm256_loadu_si256((const __m256i *)p); }
+   static void store_int(int *p, Int x) { _mm256_storeu_si256((__m256i *)p, x); }
+   static Int set1_int(int x) { return _mm256_set1_epi32(x); }
+   static Int add_int(Int x, Int y) { return _mm256_add_epi32(x, y); }
+   static Int sub_int(Int x, Int y) { return _mm256_sub_epi32(x, y); }
+   static Int mul_int(Int x, Int y) { return _mm256_mullo_epi32(x, y); }
+
+   static Dbl load_double(const int *p) {
+      return _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)p));
+   }
+   static void store_truncated(int *p, Dbl x) {
+      _mm_storeu_si128((__m128i *)p, _mm256_cvttpd_epi32(x));
+   }
+   static Dbl set1(double x) { return _mm256_set1_pd(x); }
+   static Dbl add(Dbl x, Dbl y) { return _mm256_add_pd(x, y); }
+   static Dbl sub(Dbl x, Dbl y) { return _mm256_sub_pd(x, y); }
+   static Dbl mul(Dbl x, Dbl y) { return _mm256_mul_pd(x, y); }
+   static Dbl div(Dbl x, Dbl y) { return _mm256_div_pd(x, y); }
+   static Dbl floor(Dbl x) { return _mm256_floor_pd(x); }
+   static Dbl abs(Dbl x) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), x); }
+
+   static Mask lt(Dbl x, Dbl y) { return _mm256_cmp_pd(x, y, _CMP_LT_OQ); }
+   static Mask ge(Dbl x, Dbl y) { return _mm256_cmp_pd(x, y, _CMP_GE_OQ); }
+   static Mask eq(Dbl x, Dbl y) { return _mm256_cmp_pd(x, y, _CMP_EQ_OQ); }
+   static Mask mask_xor(Mask x, Mask y) { return _mm256_xor_pd(x, y); }
+   static Dbl blend(Mask m, Dbl if_true, Dbl if_false) {
+      return _mm256_blendv_pd(if_false, if_true, m);
+   }
+};
+
+} // namespace
+
+SimdKernelTable simd_kernels_avx2() { return make_simd_kernel_table<V>(); }
@@ -0,0 +1,47 @@
+// Kernel CPU vettoriali AVX-512 (registri a 512 bit), compilati con -mavx512f.
+#include "SimdKernelsImpl.hpp"
+
+#include <immintrin.h>
+
+namespace {
+
+struct V {
+   using Int = __m512i;
+   using Dbl = __m512d;
+   using Mask = __mmask8;
+   static constexpr int INT_LANES = 16;
+   static constexpr int DBL_LANES = 8;
+
+   static Int load_int(const int *p) { return _mm512_loadu_si512(p); }
+   static void store_int(int *p, Int x) { _mm512_storeu_si512(p, x); }
+   static Int set1_int(int x) { return _mm512_set1_epi32(x); }
+   static Int add_int(Int x, Int y) { return _mm512_add_epi32(x, y); }
+   static Int sub_int(Int x, Int y) { return _mm512_sub_epi32(x, y); }
+   static Int mul_int(Int x, Int y) { return _mm512_mullo_epi32(x, y); }
+
+   static Dbl load_double(const int *p) {
+      return _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)p));
+   }
+   static void store_truncated(int *p, Dbl x) {
+      _mm256_storeu_si256((__m256i *)p, _mm512_cvttpd_epi32(x));
+   }
+   static Dbl set1(double x) { return _mm512_set1_pd(x); }
+   static Dbl add(Dbl x, Dbl y) { return _mm512_add_pd(x, y); }
+   static Dbl sub(Dbl x, Dbl y) { return _mm512_sub_pd(x, y); }
+   static Dbl mul(Dbl x, Dbl y) { return _mm512_mul_pd(x, y); }
+   static Dbl div(Dbl x, Dbl y) { return _mm512_div_pd(x, y); }
+   static Dbl floor(Dbl x) { return _mm512_roundscale_pd(x, _MM_FROUND_TO_NEG_INF); }
+   static Dbl abs(Dbl x) { return _mm512_abs_pd(x); }
+
+   static Mask lt(Dbl x, Dbl y) { return _mm512_cmp_pd_mask(x, y, _CMP_LT_OQ); }
+   static Mask ge(Dbl x, Dbl y) { return _mm512_cmp_pd_mask(x, y, _CMP_GE_OQ); }
+   static Mask eq(Dbl x, Dbl y) { return _mm512_cmp_pd_mask(x, y, _CMP_EQ_OQ); }
+   static Mask mask_xor(Mask x, Mask y) { return Mask(x ^ y); }
+   static Dbl blend(Mask m, Dbl if_true, Dbl if_false) {
+      return _mm512_mask_blend_pd(m, if_false, if_true);
+   }
+};
+
+} // namespace
+
+SimdKernelTable simd_kernels_avx512() { return make_simd_kernel_table<V>(); }
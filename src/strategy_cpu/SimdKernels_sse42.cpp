@@ -0,0 +1,47 @@
+// Kernel CPU vettoriali SSE4.2 (registri a 128 bit), compilati con -msse4.2.
+#include "SimdKernelsImpl.hpp"
+
+#include <immintrin.h>
+
+namespace {
+
+struct V {
+   using Int = __m128i;
+   using Dbl = __m128d;
+   using Mask = __m128d;
+   static constexpr int INT_LANES = 4;
+   static constexpr int DBL_LANES = 2;
+
+   static Int load_int(const int *p) { return _mm_loadu_si128((const __m128i *)p); }
+   static void store_int(int *p, Int x) { _mm_storeu_si128((__m128i *)p, x); }
+   static Int set1_int(int x) { return _mm_set1_epi32(x); }
+   static Int add_int(Int x, Int y) { return _mm_add_epi32(x, y); }
+   static Int sub_int(Int x, Int y) { return _mm_sub_epi32(x, y); }
+   static Int mul_int(Int x, Int y) { return _mm_mullo_epi32(x, y); }
+
+   static Dbl load_double(const int *p) {
+      return _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i *)p));
+   }
+   static void store_truncated(int *p, Dbl x) {
+      _mm_storel_epi64((__m128i *)p, _mm_cvttpd_epi32(x));
+   }
+   static Dbl set1(double x) { return _mm_set1_pd(x); }
+   static Dbl add(Dbl x, Dbl y) { return _mm_add_pd(x, y); }
+   static Dbl sub(Dbl x, Dbl y) { return _mm_sub_pd(x, y); }
+   static Dbl mul(Dbl x, Dbl y) { return _mm_mul_pd(x, y); }
+   static Dbl div(Dbl x, Dbl y) { return _mm_div_pd(x, y); }
+   static Dbl floor(Dbl x) { return _mm_floor_pd(x); }
+   static Dbl abs(Dbl x) { return _mm_andnot_pd(_mm_set1_pd(-0.0), x); }
+
+   static Mask lt(Dbl x, Dbl y) { return _mm_cmplt_pd(x, y); }
+   static Mask ge(Dbl x, Dbl y) { return _mm_cmpge_pd(x, y); }
+   static Mask eq(Dbl x, Dbl y) { return _mm_cmpeq_pd(x, y); }
+   static Mask mask_xor(Mask x, Mask y) { return _mm_xor_pd(x, y); }
+   static Dbl blend(Mask m, Dbl if_true, Dbl if_false) {
+      return _mm_blendv_pd(if_false, if_true, m);
+   }
+};
+
+} // namespace
+
+SimdKernelTable simd_kernels_sse42() { return make_simd_kernel_table<V>(); }
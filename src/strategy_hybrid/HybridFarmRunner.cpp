@@ -0,0 +1,136 @@
+#include "HybridFarmRunner.hpp"
+
+#include "../../include/ff_includes.hpp"
+#include "../common/StatsCollector.hpp"
+#include "../common/Tracer.hpp"
+#include "../common/WorkerLoad.hpp"
+#include "../ff_Pipe_nodes/EarliestCompletionScheduler.hpp"
+#include "../ff_Pipe_nodes/FileSink.hpp"
+#include "../ff_Pipe_nodes/FileSource.hpp"
+#include "../ff_Pipe_nodes/ff_node_acc_t.hpp"
+#include "../ff_Pipe_nodes/ff_node_cpu_t.hpp"
+#include "../strategy_cpu/CpuKernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+// Task in volo per un worker CPU: uno in calcolo e uno in coda, così il worker non resta mai
+// senza lavoro in attesa dello scheduler.
+static constexpr size_t CPU_MAX_IN_FLIGHT = 2;
+
+HybridFarmRunner::HybridFarmRunner(std::vector<std::unique_ptr<IAccelerator>> accelerators,
+                                   const std::string &kernel_name, const RunConfig &config)
+    : accelerators_(std::move(accelerators)), kernel_name_(kernel_name), config_(config) {}
+
+/**
+ * @brief Crea la farm ibrida (un nodo ff_node_acc_t per acceleratore, cpu_workers nodi
+ * ff_node_cpu_t), la esegue e raccoglie le statistiche di tutti i worker.
+ */
+ComputeResult HybridFarmRunner::execute(size_t N, size_t NUM_TASKS) {
+   if (!is_cpu_kernel(kernel_name_))
+      throw std::invalid_argument("Kernel '" + kernel_name_ +
+                                  "' has no CPU implementation for the hybrid farm.");
+
+   const size_t num_acc = accelerators_.size();
+   const size_t num_cpu = config_.cpu_workers;
+   const size_t num_workers = num_acc + num_cpu;
+   if (num_workers == 0)
+      throw std::invalid_argument("The hybrid farm needs at least one worker.");
+
+   // Thread per worker CPU: di default i core lasciati liberi da Emitter, scheduler e dai
+   // thread dei nodi ff_node_acc_t (nodo + pipeline interna), divisi fra i worker CPU.
+   size_t cpu_threads = config_.cpu_threads;
+   if (cpu_threads == 0 && num_cpu > 0) {
+      size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+      size_t reserved = 2 + num_acc * (config_.acc_stages + 1);
+      cpu_threads = std::max<size_t>((cores > reserved ? cores - reserved : 0) / num_cpu, 1);
+   }
+
+   StatsCollector stats;
+   stats.active_consumers = num_workers;
+   std::future<size_t> count_future = stats.count_promise.get_future();
+
+   // I primi num_acc worker sono gli acceleratori, i successivi i worker CPU. Con --sink i
+   // worker inviano i task completati al collector della farm, seguito dal FileSink.
+   const bool sink = !config_.sink_path.empty();
+   std::unique_ptr<ff_node> source = make_source_node(config_, N, NUM_TASKS);
+   std::unique_ptr<FileSink> file_sink;
+   if (sink)
+      file_sink = std::make_unique<FileSink>(config_.sink_path, N);
+   std::vector<WorkerLoad> loads(num_workers);
+   std::vector<std::unique_ptr<ff_node>> nodes;
+   std::vector<ff_node_acc_t *> acc_nodes;
+   for (size_t w = 0; w < num_acc; ++w) {
+      auto node =
+         std::make_unique<ff_node_acc_t>(accelerators_[w].get(), &stats, config_, &loads[w]);
+      node->set_forward_output(sink);
+      acc_nodes.push_back(node.get());
+      nodes.push_back(std::move(node));
+   }
+   for (size_t w = 0; w < num_cpu; ++w) {
+      auto node = std::make_unique<ff_node_cpu_t>(kernel_name_, cpu_threads, &stats,
+                                                  &loads[num_acc + w], config_.simd);
+      node->set_forward_output(sink);
+      nodes.push_back(std::move(node));
+   }
+
+   std::vector<ff_node *> workers;
+   for (auto &node : nodes)
+      workers.push_back(node.get());
+
+   std::vector<size_t> max_in_flight(num_workers, CPU_MAX_IN_FLIGHT);
+   std::fill_n(max_in_flight.begin(), num_acc, config_.acc_max_in_flight);
+
+   EarliestCompletionScheduler scheduler(loads, max_in_flight);
+   ff_farm farm;
+   farm.add_emitter(&scheduler);
+   farm.add_workers(workers);
+   if (!sink)
+      farm.remove_collector(); // I worker sono nodi terminali
+   ff_Pipe<> pipe(source.get(), &farm);
+   if (sink)
+      pipe.add_stage(file_sink.get());
+
+   std::cout << "[Main] Hybrid farm with " << num_acc << " accelerator and " << num_cpu
+             << " CPU workers (" << cpu_threads << " threads each).\n";
+
+   // Inizializzazione e warm-up degli acceleratori, fuori dal tempo misurato.
+   if (!ff_node_acc_t::prepare_all(acc_nodes)) {
+      std::cerr << "[ERROR] Main: Accelerator initialization failed.\n";
+      exit(EXIT_FAILURE);
+   }
+
+   std::cout << "[Main] Starting FF pipeline execution...\n";
+   auto t0 = std::chrono::steady_clock::now();
+
+   if (pipe.run_and_wait_end() < 0) {
+      std::cerr << "[ERROR] Main: Pipeline execution failed.\n";
+      exit(EXIT_FAILURE);
+   }
+
+   auto t1 = std::chrono::steady_clock::now();
+   std::cout << "[Main] FF Pipeline execution finished.\n";
+
+   for (size_t w = 0; w < num_workers; ++w)
+      std::cout << "[Main] " << (w < num_acc ? "Accelerator" : "CPU") << " worker " << w
+                << " completed " << loads[w].completed.load() << " tasks (service time "
+                << loads[w].ewma_service_ns.load() / 1.0e6 << " ms).\n";
+
+   // Raccolta dei risultati.
+   ComputeResult res;
+   res.tasks_completed = count_future.get();
+   res.elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+   stats.fill_result(res);
+   res.first_task_ns = stats.first_task_ns(t0);
+   res.warmup_tasks = num_acc > 0 ? config_.warmup_tasks : 0;
+   for (auto &accelerator : accelerators_)
+      accelerator->report_stats(res);
+
+   // I thread della pipeline sono terminati: i buffer della traccia possono essere letti.
+   Tracer::dump();
+   return res;
+}
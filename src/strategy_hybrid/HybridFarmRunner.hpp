@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../common/IDeviceRunner.hpp"
+#include "../common/RunConfig.hpp"
+#include "../strategy_accelerator/accelerator/IAccelerator.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Strategia concreta che esegue i task su CPU e acceleratori contemporaneamente.
+ *
+ * La pipeline FF è Emitter -> farm, i cui worker sono un nodo ff_node_acc_t per ogni
+ * acceleratore e RunConfig::cpu_workers nodi ff_node_cpu_t. Lo scheduler della farm
+ * (EarliestCompletionScheduler) misura il tempo di servizio di ogni worker e assegna ogni task
+ * a quello che lo completerebbe prima, così i core liberi della CPU si aggiungono al
+ * throughput degli acceleratori.
+ */
+class HybridFarmRunner : public IDeviceRunner {
+ public:
+   /**
+    * @param accelerators Acceleratori dei worker ff_node_acc_t, di cui prende possesso.
+    * @param kernel_name Nome del kernel calcolato dai worker CPU.
+    * @param config Opzioni di esecuzione (worker e thread CPU, code dei nodi acceleratore).
+    */
+   HybridFarmRunner(std::vector<std::unique_ptr<IAccelerator>> accelerators,
+                    const std::string &kernel_name, const RunConfig &config = RunConfig());
+
+   virtual ~HybridFarmRunner() = default;
+
+   ComputeResult execute(size_t N, size_t NUM_TASKS) override;
+
+ private:
+   std::vector<std::unique_ptr<IAccelerator>> accelerators_;
+   std::string kernel_name_;
+   RunConfig config_;
+};